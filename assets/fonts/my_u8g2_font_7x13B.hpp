@@ -1,36 +1,32 @@
 /*
   Fontname: -Misc-Fixed-Bold-R-Normal--13-120-75-75-C-70-ISO10646-1
   Copyright: Public domain font.  Share and enjoy.
-  Glyphs: 81/1003
+  Glyphs: 66/1003
   BBX Build Mode: 0
 */
-const uint8_t my_u8g2_font_7x13B[927] U8G2_FONT_SECTION("my_u8g2_font_7x13B") = 
-  "Q\0\3\3\3\4\2\5\4\6\15\0\376\11\376\11\0\1(\2]\3\202 \5\0\367\3&\17N\341"
-  "g$\321\323H\22\231TD\223\0(\14\314\341K\42\222\210\324D\62\1)\15\314\341C&\222\211T"
-  "D\22\21\0*\15\66\343'\24\23\35J\262P\4\0+\13\66\343K(:\224\204\42\0,\10\244\337"
-  "gE\11\0-\6\16\347\303\0.\10\234\337GB\221\0/\14N\341SM(S\224\11\205\0\60\16"
-  "N\341K\26\212\210x\222\204b\42\0\61\12N\341K\66\212\10\365d\62\15N\341\207\42\42\11E#"
-  "\231Ph\63\15N\341\303(S\243\12I\22\12\0\64\15N\341S\66\242HH\244CP\1\65\16N"
-  "\341\343\20\24VDB!IB\1\66\16N\341\207\42\42\12+\42&\11\5\0\67\15N\341\303\250&"
-  "\224\11eB\31\0\70\16N\341\207\42b\222PDL\22\12\0\71\16N\341\207\42b\222\24\205$\11"
-  "\5\0:\14\304\337GB\221\303$\24\11\0;\13\304\337GB\21O&J\0<\10N\341S\246\253"
-  "\16=\7&\345\303\16\65>\11N\341C\252\233\216\0\77\16N\341\207\42\42\11E\63\71L(\2A"
-  "\13N\341\207\42b:\214\70\11B\14N\341\243\42b\272\210\230.\0C\13N\341\207\42\42\352IB"
-  "\1D\12N\341\243\42\342\247\13\0E\13N\341\343\20T\254\10\25\15F\13N\341\343\20T\254\10\65"
-  "\2G\14N\341\207\42\42\252\224\230$\5H\12N\341C\304\351\60\342$I\11N\341\303$\324'\3"
-  "J\12N\341S\37I\22\12\0K\16N\341C\66\242HH\63\222D\211\26L\10N\341C\250\37\15"
-  "M\13N\341#\70:\34D<\11N\15N\341CD\252T\16\223&\222\0O\13N\341\207\42\342'"
-  "\11\5\0P\13N\341\243\42b\272\10\65\2Q\14V\337\207\42\342\251B\231P\5R\15N\341\243\42"
-  "b\272\220$J\264\0S\15N\341\207\42\42J\251B\222\204\2T\11N\341\303$\324O\0U\12N"
-  "\341C\304\237$\24\0V\15N\341C\304$\11e\242\11\225\0W\13N\341C\304\323\341 \32\6X"
-  "\17N\341#\70\222\204B\64\31)E\64\14Y\14N\341CD\222\220hB\235\0Z\12N\341\303\250"
-  "\246\243\320\0[\10\314\341\303\244O\4]\10\314\341\203\244O\6a\12\66\341\207*\71\221$\5b\13"
-  "N\341C\250X\21q\272\0c\13\66\341\207\42\42*I(\0d\12N\341S\313\211\223\244\0e\14"
-  "\66\341\207\42:\14E\22\12\0f\14N\341k$Q\224\321\204\332\0g\16F\335g\211$\241H)"
-  "\42\11\5\0h\12N\341C\250X\21\361$i\12N\341K(\7\15u\62j\14^\335S\35&\324"
-  "\221$\241\0k\15N\341C\250\211\42!\221$J\2l\10N\341g\250\237\14m\12\66\341C\42\71"
-  "\234\230\4n\11\66\341\243\42\342I\0o\12\66\341\207\42\342$\241\0p\13F\335\243\42b\272\10\25"
-  "\1q\11F\335\347\304$)jr\11\66\341\243\42\42j\4s\15\66\341\207\42\222\210%\42\11\5\0"
-  "t\14F\341G(+\11\265\210&\0u\11\66\341C\304\223\244\0v\13\66\341C\304$!\321D\0"
-  "w\13\66\341C\304t\270\204\42\0x\14\66\341CD\222\220(\42\222\0y\14F\335C\304IR$"
-  "I(\0z\12\66\341\303(\23\311\204\6\260\12&\353\207\42\42I(\0\0\0\0\4\377\377\0";
+const uint8_t my_u8g2_font_7x13B[777] U8G2_FONT_SECTION("my_u8g2_font_7x13B") = 
+  "B\0\3\3\3\4\2\5\4\6\15\0\376\11\376\11\0\0\375\1\346\2\354 \5\0\367\3#\20\315\341"
+  "')\22\71LR\16\223\244H\4\0%\17N\341c$\211T\202\62\305H%\42\32&\17N\341g"
+  "$\321\323H\22\231TD\223\0(\14\314\341K\42\222\210\324D\62\1)\15\314\341C&\222\211TD"
+  "\22\21\0-\6\16\347\303\0.\10\234\337GB\221\0/\14N\341SM(S\224\11\205\0\60\16N"
+  "\341K\26\212\210x\222\204b\42\0\61\12N\341K\66\212\10\365d\62\15N\341\207\42\42\11E#\231"
+  "Ph\63\15N\341\303(S\243\12I\22\12\0\64\15N\341S\66\242HH\244CP\1\65\16N\341"
+  "\343\20\24VDB!IB\1\66\16N\341\207\42\42\12+\42&\11\5\0\67\15N\341\303\250&\224"
+  "\11eB\31\0\70\16N\341\207\42b\222PDL\22\12\0\71\16N\341\207\42b\222\24\205$\11\5"
+  "\0:\14\304\337GB\221\303$\24\11\0=\7&\345\303\16\65A\13N\341\207\42b:\214\70\11B"
+  "\14N\341\243\42b\272\210\230.\0C\13N\341\207\42\42\352IB\1D\12N\341\243\42\342\247\13\0"
+  "E\13N\341\343\20T\254\10\25\15F\13N\341\343\20T\254\10\65\2G\14N\341\207\42\42\252\224\230"
+  "$\5H\12N\341C\304\351\60\342$I\11N\341\303$\324'\3K\16N\341C\66\242HH\63\222"
+  "D\211\26L\10N\341C\250\37\15M\13N\341#\70:\34D<\11N\15N\341CD\252T\16\223"
+  "&\222\0O\13N\341\207\42\342'\11\5\0P\13N\341\243\42b\272\10\65\2Q\14V\337\207\42\342"
+  "\251B\231P\5R\15N\341\243\42b\272\220$J\264\0S\15N\341\207\42\42J\251B\222\204\2T"
+  "\11N\341\303$\324O\0U\12N\341C\304\237$\24\0W\13N\341C\304\323\341 \32\6a\12\66"
+  "\341\207*\71\221$\5b\13N\341C\250X\21q\272\0c\13\66\341\207\42\42*I(\0d\12N"
+  "\341S\313\211\223\244\0e\14\66\341\207\42:\14E\22\12\0f\14N\341k$Q\224\321\204\332\0g"
+  "\16F\335g\211$\241H)\42\11\5\0h\12N\341C\250X\21\361$i\12N\341K(\7\15u"
+  "\62k\15N\341C\250\211\42!\221$J\2l\10N\341g\250\237\14m\12\66\341C\42\71\234\230\4"
+  "n\11\66\341\243\42\342I\0o\12\66\341\207\42\342$\241\0p\13F\335\243\42b\272\10\25\1r\11"
+  "\66\341\243\42\42j\4s\15\66\341\207\42\222\210%\42\11\5\0t\14F\341G(+\11\265\210&\0"
+  "u\11\66\341C\304\223\244\0v\13\66\341C\304$!\321D\0w\13\66\341C\304t\270\204\42\0x"
+  "\14\66\341CD\222\220(\42\222\0y\14F\335C\304IR$I(\0\260\12&\353\207\42\42I("
+  "\0\0\0\0\4\377\377\0";
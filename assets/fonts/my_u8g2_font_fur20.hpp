@@ -1,18 +1,18 @@
 /*
   Fontname: -FreeType-FreeUniversal-Medium-R-Normal--28-280-72-72-P-133-ISO10646-1
   Copyright: (FreeUniversal) Copyright (c) Stephen Wilson 2009    a modification of:    Original Font (SIL Sophia)  Copyright (c) SIL International, 1994-2008.    
-  Glyphs: 12/243
+  Glyphs: 13/243
   BBX Build Mode: 0
 */
-const uint8_t my_u8g2_font_fur20[324] U8G2_FONT_SECTION("my_u8g2_font_fur20") = 
-  "\14\0\4\3\4\5\3\1\6\17\24\0\0\24\373\24\374\0\0\0\0\1' \5\0\30\5.\7\63\36"
-  "\205\3\1\60!M\33\246\262\3\231\241\31\261\21\261\211\71\211\71\211\71\177'\61'\42\66\62\65#\64"
-  "t\20W\4\61\16H\37&\232\222\203\203\21\242\251\375\177\62\30L\35\36\253\203\230)\221)\263\311\15"
-  "\7\351\10wH\307\360\340\301\0\63\36M\33\246\262\3\231\251\221\61\211\271\321Q\311\271\302\332M\355\354"
-  "\316&\246f\16\244\214\0\64\36N\33F\312\206v\23s\42c#S\63SB\333L\315\210\215\214\215"
-  "\34|\71\273\23\0\65 M\33\206\3\222\3\222\321\275(: \241\232\30\233\230\223\35\35\265\223\30\33"
-  "\31\232\71\20\63\2\66\37M\33&\253\3\31\242\221\61\211\71\323%\65\7$\65\24s~\67!'#"
-  "\65s V\4\67\26L\35\206\17&WJ.\234\234\224\134)\271pr\341\344\30\0\70\42M\33\246"
-  "\262\3\231\251\211\71\211\71\273\11\71\221\251\241\263\253!\31\71\211\71\337ML\315\34\210\25\1\71\37M"
-  "\33\236\253\3\231\251\211\71\277\233\230\42\71\240)\31]*\42'\42\66\62\64t\20f\4\0\0\0\4"
-  "\377\377\0";
+const uint8_t my_u8g2_font_fur20[336] U8G2_FONT_SECTION("my_u8g2_font_fur20") = 
+  "\15\0\4\3\4\5\3\4\6\17\24\0\0\24\373\24\374\0\0\0\0\1\63 \5\0\210(-\6'\352"
+  ")<.\7\63\216(\34\10\60\42M\213\60\225\35\310\14\315\210\215\210M\314I\314I\314\371;\211\71"
+  "\21\261\221\251\31\241\241\203\270\42\0\61\17H\217\60\321\224\34\34\214\20M\355\377\3\62\30L\215\360X"
+  "\35\304L\211L\231Mn\70HG\270C:\206\7\17\6\63\36M\213\60\225\35\310L\215\214I\314\215"
+  "\216J\316\25\326njgw\66\61\65s e\4\64\36N\213\60R\66\264\233\230\23\31\33\231\232\231"
+  "\22\332fjFldl\344\340\313\331\235\0\65!M\213\60\34\220\34\220\214\356E\321\1\11\325\304\330"
+  "\304\234\354\350\250\235\304\330\310\320\314\201\230\21\0\66 M\213\60Y\35\310\20\215\214I\314\231.\251\71"
+  " \251\241\230\363\273\11\71\31\251\231\3\261\42\0\67\26L\215\60|\60\271Rr\341\344\244\344J\311\205"
+  "\223\13'\307\0\70#M\213\60\225\35\310LM\314I\314\331M\310\211L\15\235]\15\311\310I\314\371"
+  "nbj\346@\254\10\0\71 M\213\360\134\35\310LM\314\371\335\304\24\311\1M\311\350R\21\71\21"
+  "\261\221\241\241\203\60#\0\0\0\0\4\377\377\0";
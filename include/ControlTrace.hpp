@@ -0,0 +1,56 @@
+#ifndef ControlTrace_h
+#define ControlTrace_h
+
+#include <Arduino.h>
+#include "Hotplate.hpp"
+
+#define TRACE_SAMPLES 64            // 64 * 3 byte = 192 byte RAM. @ PID_SAMPLE_MS (250ms) = last 16s of control
+#define TRACE_SAMPLE_SIZE 3         // Packed sample size (byte)
+#define TRACE_MAGIC "HPTR"          // Binary dump header magic
+#define TRACE_FORMAT_VERSION 2
+
+/*
+ * RAM resident circular trace of the last TRACE_SAMPLES control ticks, for post-mortem analysis
+ * (i.e. overshoot or a stuck SSR) without a logging laptop.
+ *
+ * Packed sample (3 byte, little endian bit order):
+ *   Bit  0..8   Input (°C, 0..510, 511 = sensor fault)
+ *   Bit  9..12  Duty (0..15 = 0..100% of the PWM window)
+ *   Bit 13..15  State code: 0..3 = Hotplate::Control (Off, PID, BangOn, BangOff), 4 = Tuner wait, 5 = Tuner heat,
+ *               6 = Tuner settle, 7 = Fault (see Hotplate::StateInfo)
+ *   Bit 16..23  Setpoint (°C)
+ * The tick is implicit: Samples are PID_SAMPLE_MS apart, the newest tick gets stored once.
+ *
+ * The trace freezes on a fault (sensor, over-temperature = HOTPLATE_OVERTEMP_MARGIN_C above max_temp_c), on "push & turn" of the knob, or via serial command.
+ * Binary dump (see scripts/trace_decode.py):
+ *   "HPTR", version (uint8), sample size (uint8), count (uint16), interval (uint16 ms), newest tick (uint32 ms),
+ *   freeze reason (uint8), samples (oldest first), CRC32 (uint32) of all previous bytes
+ */
+class ControlTrace
+{
+public:
+    enum class Freeze : uint8_t
+    {
+        None,
+        Button,
+        Command,
+        SensorFault,
+        OverTemp,
+    };
+
+    void record(uint32_t tick_ms, double input, double setpoint, double output, uint8_t state);
+
+    void freeze(Freeze reason);
+    bool isFrozen() { return _freeze != Freeze::None; };
+
+    void dump();
+
+private:
+    uint8_t _samples[TRACE_SAMPLES][TRACE_SAMPLE_SIZE];
+    uint8_t _head = 0; // Next write position
+    uint8_t _count = 0;
+    uint32_t _lastTick_ms = 0;
+    Freeze _freeze = Freeze::None;
+};
+
+#endif
@@ -0,0 +1,79 @@
+#ifndef Fan_h
+#define Fan_h
+
+#include <Arduino.h>
+#include "FastGpio.hpp"
+
+#define FAN_WINDOW_MS 1000 // Soft PWM window. Slow enough for a SSR (AC blower) as well as for a MOSFET switched DC fan
+#define FAN_RATE_KI 1      // Closed loop: Duty change (of 255) per step and 0.1 °C/s cool down rate error
+
+/*
+ * Cooling fan/blower on a compile time pin (see FastGpio.hpp), soft PWM with duty 0..255.
+ * Either open loop (setDuty()), or closed loop on the measured cool down rate (trackRate()).
+ */
+template <uint8_t PIN>
+class Fan
+{
+public:
+    Fan() { FastPin<PIN>::output(); };
+
+    void setDuty(uint8_t duty)
+    {
+        _duty = duty;
+        _tracking = false;
+    };
+
+    uint8_t getDuty() { return _duty; };
+
+    /**
+     * @brief Closed loop cool down, to get called once per step_ms. The error between the target and the measured
+     * cool down rate (derivative of the plate temp) gets integrated into the duty. The fan reacts without notable
+     * delay, so a pure (slow) integral controller is sufficient, and it low passes the noisy derivative as well.
+     * The duty doesn't get raised while the plate still heats up (heat in flight at the begin of the cool down,
+     * which the fan can't compensate), nor while the plate is already at or below the setpoint curve
+     * (so that fan and heater don't fight).
+     *
+     * @param temp_dc Plate temperature (1/10 °C)
+     * @param setpoint_dc Profile curve (1/10 °C)
+     * @param rate_dcs Target cool down rate (1/10 °C per s)
+     * @param step_ms Call interval
+     */
+    void trackRate(int16_t temp_dc, int16_t setpoint_dc, uint8_t rate_dcs, uint16_t step_ms)
+    {
+        if (!_tracking)
+        {
+            _tracking = true;
+            _lastTemp_dc = temp_dc;
+            return;
+        }
+
+        int16_t measured_dcs = (int32_t)(_lastTemp_dc - temp_dc) * 1000 / step_ms;
+        _lastTemp_dc = temp_dc;
+
+        int16_t error_dcs = rate_dcs - measured_dcs; // > 0: Cools down too slow
+        if (error_dcs > 0 && (temp_dc <= setpoint_dc || measured_dcs <= 0))
+        {
+            error_dcs = 0;
+        }
+        _duty = constrain(_duty + error_dcs * FAN_RATE_KI, 0, 255);
+    };
+
+    void loop()
+    {
+        uint32_t now = millis();
+
+        if (now - _windowStart_ms >= FAN_WINDOW_MS)
+        {
+            _windowStart_ms = now;
+        }
+        FastPin<PIN>::write(_duty && (uint32_t)_duty * FAN_WINDOW_MS / 255 > now - _windowStart_ms);
+    };
+
+private:
+    uint8_t _duty = 0;
+    bool _tracking = false;
+    int16_t _lastTemp_dc = 0;
+    uint32_t _windowStart_ms = 0;
+};
+
+#endif
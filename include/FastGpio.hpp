@@ -0,0 +1,60 @@
+#ifndef FastGpio_h
+#define FastGpio_h
+
+#include <Arduino.h>
+
+/*
+ * Compile time resolved GPIO for the ATmega328 (Arduino Nano/Uno pin numbering):
+ *   D0-D7 = PORTD, D8-D13 = PORTB, A0-A5 (D14-D19) = PORTC
+ *
+ * Every access compiles to a single sbi/cbi (2 cycles) resp. sbis/sbic instruction, whereas digitalWrite()
+ * does pin table lookups in flash, a PWM timer check (SSR_Pin D5 is OC0B, so it always clears COM0B1 as well) and
+ * a SREG save/restore. env:BENCH reports both ("digitalWrite(SSR_Pin)" vs. "FastPin<SSR_Pin>::write").
+ * Like sbi/cbi, the read-modify-write is atomic, thus it's ISR safe as well.
+ *
+ * Host (non AVR) builds fall back to the Arduino API, so that the replay shim keeps seeing all pin changes.
+ */
+template <uint8_t PIN>
+class FastPin
+{
+public:
+    static_assert(PIN < 20, "FastPin: Not an ATmega328 pin");
+
+    static const uint8_t BIT = PIN < 8 ? PIN : (PIN < 14 ? PIN - 8 : PIN - 14);
+    static const uint8_t MASK = 1 << BIT;
+
+#ifdef __AVR__
+    static inline void output() __attribute__((always_inline)) { ddr() |= MASK; };
+    static inline void input() __attribute__((always_inline)) { ddr() &= ~MASK; port() &= ~MASK; };
+    static inline void inputPullup() __attribute__((always_inline)) { ddr() &= ~MASK; port() |= MASK; };
+    static inline void high() __attribute__((always_inline)) { port() |= MASK; };
+    static inline void low() __attribute__((always_inline)) { port() &= ~MASK; };
+    static inline void toggle() __attribute__((always_inline)) { pin() = MASK; }; // Writing 1 to PINx toggles PORTx
+    static inline bool read() __attribute__((always_inline)) { return pin() & MASK; };
+#else
+    static inline void output() { pinMode(PIN, OUTPUT); };
+    static inline void input() { pinMode(PIN, INPUT); };
+    static inline void inputPullup() { pinMode(PIN, INPUT_PULLUP); };
+    static inline void high() { digitalWrite(PIN, HIGH); };
+    static inline void low() { digitalWrite(PIN, LOW); };
+    static inline void toggle() { digitalWrite(PIN, !digitalRead(PIN)); };
+    static inline bool read() { return digitalRead(PIN); };
+#endif
+
+    static inline void write(bool level) __attribute__((always_inline))
+    {
+        if (level)
+            high();
+        else
+            low();
+    };
+
+private:
+#ifdef __AVR__
+    static inline volatile uint8_t &port() __attribute__((always_inline)) { return PIN < 8 ? PORTD : (PIN < 14 ? PORTB : PORTC); };
+    static inline volatile uint8_t &ddr() __attribute__((always_inline)) { return PIN < 8 ? DDRD : (PIN < 14 ? DDRB : DDRC); };
+    static inline volatile uint8_t &pin() __attribute__((always_inline)) { return PIN < 8 ? PIND : (PIN < 14 ? PINB : PINC); };
+#endif
+};
+
+#endif
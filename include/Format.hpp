@@ -0,0 +1,59 @@
+#ifndef Format_h
+#define Format_h
+
+#include <Arduino.h>
+
+/**
+ * @brief Integer to decimal digits, right aligned at the end of buf. Replaces sprintf()/dtostrf(),
+ * so that the printf machinery doesn't get linked at all
+ *
+ * @param buf Buffer, gets '\0' terminated at size - 1. Needs digits (+ '.') + sign (if negative) + '\0' bytes
+ * @param value Value, in 1/10 units if decimal
+ * @param width Min. width (space padded)
+ * @param decimal Format with one decimal place
+ * @return Start of the formatted number within buf
+ */
+template <typename T>
+inline char *formatNumber(char *buf, uint8_t size, T value, uint8_t width = 0, bool decimal = false)
+{
+    char *end = buf + size - 1, *p = end;
+    bool negative = value < 0;
+    uint8_t digits = 0;
+
+    *p = '\0';
+    if (negative)
+    {
+        value = -value;
+    }
+    do
+    {
+        if (decimal && digits == 1)
+        {
+            *--p = '.';
+        }
+        *--p = '0' + value % 10;
+        value /= 10;
+        digits++;
+    } while ((value || (decimal && digits < 2)) && p - buf >= 1 + (decimal && digits == 1) + negative); // Room for the next digit ('.', sign)
+    if (negative)
+    {
+        *--p = '-';
+    }
+    while (end - p < width && p > buf)
+    {
+        *--p = ' ';
+    }
+    return p;
+}
+
+/**
+ * @brief Append formatNumber() of value to the string in line
+ */
+template <typename T>
+inline void appendNumber(char *line, T value, uint8_t width = 0, bool decimal = false)
+{
+    char buf[12]; // "-4294967295\0"
+    strcat(line, formatNumber(buf, sizeof(buf), value, width, decimal));
+}
+
+#endif
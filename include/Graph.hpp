@@ -0,0 +1,53 @@
+#ifndef Graph_h
+#define Graph_h
+
+#include <Arduino.h>
+
+#define GRAPH_COLUMNS 128 // Display width. One byte (°C) per column = 128 byte RAM
+#define GRAPH_VERTICES 16 // Profile curve polyline, 4 byte each. A profile needs ~2 per segment (start and clamp)
+
+/*
+ * Temperature history of the (last) profile run for the graph screen, sampled once per PROFILE_STEP_MS.
+ *
+ * Temperatures get stored with one byte per display column. A column covers 2^shift samples: If the run outgrows
+ * the display width, adjacent columns get merged and the samples per column double (decimation), so that the whole
+ * run always fits. Merging is min/max style: Of the samples within a column, the one with the larger deviation from
+ * the profile curve gets kept, so that overshoot and lag peaks don't get averaged away.
+ *
+ * The profile curve is piecewise linear (ramps and holds), so it gets stored as polyline of its vertices
+ * (sample index, setpoint) instead of per column, and stays exact at any decimation.
+ */
+class Graph
+{
+public:
+    typedef struct
+    {
+        uint16_t sample; // Sample index since the run start
+        int16_t temp_dc; // Profile curve (1/10 °C)
+    } Vertex;
+
+    void start();
+    void record(int16_t temp_dc, int16_t setpoint_dc);
+
+    uint8_t getColumns() { return _columns; };               // Used columns
+    uint8_t getColumn(uint8_t x) { return _temp_c[x]; };     // Temperature (°C) of column x
+    uint8_t getShift() { return _shift; };                   // Column x covers samples x << shift .. (x + 1) << shift
+    uint16_t getSamples() { return _samples; };
+    uint8_t getVertices() { return _vertices; };
+    const Vertex &getVertex(uint8_t i) { return _curve[i]; };
+    uint8_t getRevision() { return _revision; };             // Changes with every record()
+
+    int16_t curveAt(uint16_t sample);
+
+private:
+    uint8_t _temp_c[GRAPH_COLUMNS];
+    Vertex _curve[GRAPH_VERTICES];
+    uint16_t _samples = 0;
+    uint16_t _columnDeviation_dc; // Deviation of the kept sample of the last column
+    uint8_t _columns = 0, _shift = 0, _vertices = 0, _revision = 0;
+
+    void decimate();
+    void recordCurve(int16_t setpoint_dc);
+};
+
+#endif
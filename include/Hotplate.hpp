@@ -7,79 +7,157 @@
 
 #include <AutoPID.h>
 
-#define PID_SAMPLE_MS 250 // Should be the shortest PTC-on time, but not shorter than a typical inrush-current period of a PTC (approx. 0.1s)
-
+#ifndef PID_SAMPLE_MS
+#define PID_SAMPLE_MS 250 // Should be the shortest PTC-on time, but not shorter than a typical inrush-current period of a PTC (approx. 0.1s). >= TC_MAX_READ_INTERVAL_MS
+#endif
+
+#ifndef HOTPLATE_CHANNELS
+#define HOTPLATE_CHANNELS 1               // Heater channels (SSR + thermocouple + PID state), approx. 90 byte RAM each (see env:ATMEGA328_NEW_FTDI_2CH)
+#endif
+#define HOTPLATE_PROFILE_UNBOUND INT8_MIN // Profile offset of a channel which doesn't follow the reflow profile (manual setpoint only)
+#define HOTPLATE_SWITCH_GAP_MS 100        // Min. time between SSR switch-on's of different channels (PTC inrush current period)
+#define HOTPLATE_OVERTEMP_MARGIN_C 20     // Fault if the temp exceeds max_temp_c by this margin
+
+static_assert(HOTPLATE_CHANNELS >= 1 && HOTPLATE_CHANNELS <= 2, "Pins (SSR_Pin/SSR2_PIN, TC_CS_PIN/TC2_CS_PIN) exist for up to two channels");
+
+/*
+ * One heater channel. Channel 0 is the lead channel, whose thermocouple drives the reflow profile.
+ * The SSR windows (and control ticks) of the channels are phase shifted by 1/HOTPLATE_CHANNELS,
+ * so that the channels never switch on together (combined inrush current).
+ */
 class Hotplate
 {
-    const uint8_t _ssrPin;
+    const uint8_t _channel;
+    const int8_t _profileOffset_c;
 
 public:
     /*
-     * FIXME: Should switch to "flagged enums" and merge them to State,
-     * but they're tricky/ugly with <= C 11.x
+     * Control flow states of a channel. Each state has an entry, tick and exit handler (see _stateHandlers)
+     * and a display descriptor (see StateInfo). State changes happen only via dispatch() of an Event,
+     * along the flash resident transition table (see _transitions).
      */
-    enum class Mode : uint8_t
+    enum class State : uint8_t
     {
-        Manual = 0x0,
-        PIDTuner = 0x1,
+        StandBy,     // Heater off, setpoint 0
+        Manual,      // PID on the manual setpoint
+        Profile,     // PID on the setpoint of the reflow profile (or its standby hold)
+        TunerArmed,  // PID Tuner: Waiting for "Press to start"
+        TunerStart,  // PID Tuner: Print header
+        TunerWait,   // PID Tuner: Wait one pwmWindow with 0 output
+        TunerHeat,   // PID Tuner: Full power up to the target temp
+        TunerSettle, // PID Tuner: Off until the temp settled
+        Fault,       // Sensor fault or over temperature: Heater off, latched until Stop
+        Count,
+    };
+
+    enum class Event : uint8_t
+    {
+        Stop,       // User stop (push), the only way out of Fault
+        Setpoint,   // Non zero setpoint got latched
+        Off,        // Setpoint 0
+        Profile,    // Profile (or its hold) started
+        ProfileEnd, // Profile stopped
+        Tune,       // Arm the PID Tuner
+        Start,      // Start an armed process (push)
+        Next,       // PID Tuner: Next step
+        Done,       // PID Tuner: Done
+        Fault,      // Sensor fault or over temperature
+        Count,
     };
 
     /*
-     * This State enum is for informational (display) AS WELL AS control flow purposes.
-     * It has mixed usage mainly to save some byte.
-     * At the moment there's only the PIDTuner who's using the control flow related items
-     * like (StandBy), Start, Heating and Settle and the used names are held to be generic,
-     * so that they can be used also for other (future) control flows.
-     *
-     * FIXME: Should switch to "flagged enums" and merge also Mode here,
-     * but they're tricky/ugly with <= C 11.x
+     * Active (PID) controller output, for display purposes. Values are the ControlTrace state codes 0..3
      */
-    enum class State : uint8_t
+    enum class Control : uint8_t
     {
-        // Control flow purposes
-        StandBy = 0x0, // Waiting for "Press to start" (a process flow)
-        Start = 0x1,   // Start flow
-        Wait = 0x2,    // Wait some off time
-        Heat = 0x4,    // Heat up to to target temp
-        Settle = 0x8,  // Wait temp get settled
-                       // Informational (display) purposes
-        BangOn = 0x10,
-        BangOff = 0x20,
-        PID = 0x40,
+        Off,
+        PID,
+        BangOn,
+        BangOff,
     };
 
-    Hotplate(uint8_t ssr_pin);
+    static const uint8_t STATE_HEATING = 0x01; // SSR gets driven by the output (soft PWM)
+    static const uint8_t STATE_TUNER = 0x02;   // PID Tuner state (no profile, serial tuner output while heating)
+
+    /*
+     * Display descriptor of a State (flash resident, see getStateInfo())
+     */
+    typedef struct
+    {
+        uint8_t flags;  // STATE_*
+        uint8_t trace;  // ControlTrace state code, 0 = Control
+        char title[17]; // Main screen 1st row, empty = profile name
+        char hint[14];  // Main screen 2nd row instead of the target temp, empty = target
+    } StateInfo;
+
+    Hotplate(uint8_t channel, int8_t profile_offset_c = 0);
 
     void setup();
     void loop();
 
-    Mode getMode() { return _mode; };
     uint16_t getOutput() { return _output; };
     bool getPower() { return _power; };
-    uint16_t getSetpoint() { return _setpoint; };
+    uint32_t getOnTime_ms() { return _onTime_ms + (_power ? millis() - _powerOn_ms : 0); }; // SSR on-time since setup
+    uint32_t getSwitches() { return _switches; };                                           // SSR switch-on's since setup
+    uint16_t getSetpoint() { return _target; }; // Commanded setpoint (the PID setpoint may still be slewing)
     State getState() { return _state; };
+    Control getControl() { return _control; };
+    void getStateInfo(StateInfo &info) { memcpy_P(&info, &_stateInfo[static_cast<uint8_t>(_state)], sizeof(info)); };
 
-    bool isStandBy() { return (isMode(Mode::PIDTuner) && isState(State::StandBy)); };
-    bool isMode(Mode checkMode) { return _mode == checkMode; };
+    bool isProfileBound() { return _profileOffset_c != HOTPLATE_PROFILE_UNBOUND; };
+    bool isArmed() { return _state == State::TunerArmed; };
+    bool isHeating() { return pgm_read_byte(&_stateInfo[static_cast<uint8_t>(_state)].flags) & STATE_HEATING; };
     bool isState(State checkState) { return _state == checkState; };
 
-    void setMode(Mode newMode) { _mode = newMode; };
-    void setState(State newState) { _state = newState; };
+    bool dispatch(Event ev);
     void setSetpoint(uint16_t setpoint);
+    void setProfileSetpoint(uint16_t setpoint);
 
     void updatePidGains();
 
 private:
+    friend class Benchmark; // See main_bench.cpp
+
     AutoPID _myPID;
     double _input, _setpoint = 0, _output = 0;
+    uint16_t _target = 0;     // Commanded setpoint (knob or profile), followed by the next control tick
+    bool _targetOff = false;  // Setpoint 0 got commanded, switched off (Event::Off) by the next control tick
     uint32_t _nextInterval_ms = 0, _pwmWindowStart_ms, _pidTunerOutputNext_ms = 0;
-    Mode _mode = Mode::Manual;
     State _state = State::StandBy;
+    Control _control = Control::Off;
     bool _power = false;
+    uint32_t _powerOn_ms, _onTime_ms = 0, _switches = 0; // SSR accounting (energy, relay wear)
 
     uint16_t _pidTunerTempTarget, _pidTunerTempMax;
 
+    typedef void (Hotplate::*Handler)(uint32_t now);
+    typedef struct
+    {
+        Handler entry, tick, exit; // nullptr = none
+    } StateHandlers;
+
+    static const StateHandlers _stateHandlers[static_cast<uint8_t>(State::Count)];                          // PROGMEM
+    static const StateInfo _stateInfo[static_cast<uint8_t>(State::Count)];                                  // PROGMEM
+    static const State _transitions[static_cast<uint8_t>(State::Count)][static_cast<uint8_t>(Event::Count)]; // PROGMEM
+
+#if HOTPLATE_CHANNELS > 1
+    static uint32_t _lastSwitchOn_ms; // Last SSR switch-on of any channel
+#endif
+
+    void enterStandBy(uint32_t now);
+    void enterPid(uint32_t now);
+    void exitPid(uint32_t now);
+    void enterTunerWait(uint32_t now);
+    void enterTunerSettle(uint32_t now);
+    void enterFault(uint32_t now);
+    void tickPid(uint32_t now);
+    void tickTunerStart(uint32_t now);
+    void tickTunerWait(uint32_t now);
+    void tickTunerHeat(uint32_t now);
+    void tickTunerSettle(uint32_t now);
+
     bool pwmWindowReached();
+    uint32_t getWindowStart(uint32_t now);
     void setPower(bool);
 };
 
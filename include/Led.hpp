@@ -2,6 +2,7 @@
 #define Led_h
 
 #include <Arduino.h>
+#include "FastGpio.hpp"
 
 #define LED_WARM_TEMP 50     // > temp for Warm LED FIXME: Need to become dynamic on C/F unit
 #define LED_WARM_MILLIS 1000 // Hot-LED blink rate (ms)
@@ -9,14 +10,35 @@
 #define LED_HOT_TEMP 100   // > temp for Warm LED FIXME: Need to become dynamic on C/F unit
 #define LED_HOT_MILLIS 500 // Hot-LED blink rate (ms)
 
+/*
+ * LED on a compile time pin (see FastGpio.hpp)
+ */
+template <uint8_t PIN>
 class Led
 {
-    const uint8_t _pin;
-
 public:
-    Led(const uint8_t pin);
+    Led() { FastPin<PIN>::output(); };
 
-    void blinkByTemp(const float temp);
+    void blinkByTemp(const float temp)
+    {
+        uint32_t currentMillis = millis();
+        if (temp >= (LED_WARM_TEMP + LED_HOT_TEMP))
+        {
+            FastPin<PIN>::high(); // Very-Hot LED
+            return;
+        }
+        if (temp >= LED_HOT_TEMP)
+        {
+            FastPin<PIN>::write((currentMillis / LED_HOT_MILLIS) % 2); // Hot LED
+            return;
+        }
+        if (temp >= LED_WARM_TEMP)
+        {
+            FastPin<PIN>::write((currentMillis / LED_WARM_MILLIS) % 2); // Warm LED
+            return;
+        }
+        FastPin<PIN>::low();
+    };
 };
 
-#endif
\ No newline at end of file
+#endif
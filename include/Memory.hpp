@@ -0,0 +1,28 @@
+#ifndef Memory_h
+#define Memory_h
+
+#include <Arduino.h>
+
+#define MEMORY_CANARY 0xC5 // Stack paint pattern. Any value which is unlikely to get written by regular stack usage
+
+/*
+ * RAM usage monitor for the (2 KB) ATmega328.
+ *
+ * The free RAM between the end of .bss and the initial stack pointer gets painted with MEMORY_CANARY
+ * during startup (see .init3 section in Memory.cpp). Whatever got touched since, either by stack or by heap,
+ * is no longer painted. Scanning the painted area results in the stack high-water mark,
+ * whereas the heap extent (__brkval) gets sampled via update().
+ */
+namespace Memory
+{
+    void update(); // Sample heap top. Cheap enough to get called every loop()
+
+    uint16_t getFreeRam();   // Current gap between heap top and stack pointer
+    uint16_t getUnusedRam(); // Low-water mark: Painted bytes which were never touched (by stack or heap)
+    uint16_t getStackPeak(); // Max. stack usage (bytes) since startup
+    uint16_t getHeapPeak();  // Max. heap usage (bytes) since startup
+
+    void printReport(); // Serial report
+}
+
+#endif
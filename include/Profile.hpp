@@ -1,7 +1,17 @@
 #ifndef Profile_h
 #define Profile_h
 
-#define PROFILE_TIME_INTERVAL_MS 10000 // Allows a user to adjust the target for the amount of interval
+#include "Hotplate.hpp"
+
+#define PROFILE_STEP_MS 1000          // Segment interpreter (setpoint) and run metrics rate
+#define PROFILE_TEMP_BAND_C 3         // HoldTemp: Plate temp is within band of the hold temp
+#define PROFILE_SEGMENT_MAX_S 300     // Safety net: A segment ends latest after this time (i.e. if a target is beyond max_temp_c)
+#define PROFILE_SEGMENTS_MAX 6        // Max. segments of a profile (run metrics duty per segment)
+#define PROFILE_HIGH_TEMP_MAX_C 250   // Max. peak of the high temp. profiles, which need max_temp_c raised (compile time check)
+#define PROFILE_AMBIENT_C 25          // Nominal start temperature of the built-in profiles (compile time check)
+#define PROFILE_RATE_SHIFT 12         // Fixed point of SegmentPlan::invRate (1 << PROFILE_RATE_SHIFT = 1 / (0.1 °C per s))
+#define PROFILE_DUTY_SKIPPED 0xFF     // Run metrics: Segment didn't run (warm start)
+#define PROFILE_NAME_SIZE 19          // Longest profile name + '\0'
 
 class Profile
 {
@@ -13,48 +23,153 @@ public:
         Sn965Ag30Cu05,
     };
 
-    const char *profile2str[3] = {
-        [Manual] = "Manual",
-        [Sn42Bi576Ag04] = "Sn42/Bi57.6/Ag0.4",
-        [Sn965Ag30Cu05] = "Sn96.5/Ag3.0/Cu0.5",
+    static const char profileNames[3][PROFILE_NAME_SIZE]; // PROGMEM
+    static const char *getName(char *name, Profiles p) // Copy of the (flash resident) name
+    {
+        memcpy_P(name, profileNames[p], PROFILE_NAME_SIZE);
+        return name;
+    };
+
+    /*
+     * Run quality metrics, computed incrementally (O(1) state) during a profile run.
+     * Temperatures are in 1/10 °C to get along without float.
+     */
+    typedef struct
+    {
+        int16_t peak_dc;           // Peak temperature
+        uint16_t aboveLiquidus_s;  // Time above liquidus
+        int16_t maxRamp_dcs;       // Max. ramp rate (1/10 °C per s)
+        uint16_t maxDeviation_dc;  // Max. absolute deviation from the profile curve
+        uint32_t iae_dcs;          // Integral absolute error against the profile curve (1/10 °C * s)
+        uint16_t duration_s;       // Run duration
+        Profiles profile;
+        uint16_t energy_dWh;       // Heater energy of all profile bound channels (1/10 Wh, Config::heater_10w)
+        uint16_t switches;         // SSR switch-on's (lead channel)
+        uint8_t segmentDuty[PROFILE_SEGMENTS_MAX]; // Avg. SSR duty (%) per segment (lead channel), or PROFILE_DUTY_SKIPPED
+    } RunMetrics;
+
+    /*
+     * Profile segment types. A segment ends on time and/or on the (lead channel) plate temperature
+     */
+    enum class SegmentType : uint8_t
+    {
+        RampRate, // Ramp the setpoint by rate up to temp_c. Ends if the plate reached temp_c (or timeout)
+        HoldTime, // Hold temp_c for time_s (i.e. soak)
+        HoldTemp, // Hold temp_c until the plate reached it (or timeout)
+        Dwell,    // Hold temp_c (peak) until the plate was time_s above threshold (i.e. time above liquidus)
+        CoolRate, // Lower the setpoint by rate down to temp_c. Ends if the plate is below temp_c (or timeout). The fan tracks the rate
+    };
+
+    /*
+     * Batch production: Run the profile Config::batch_runs times, with a cool down to Config::batch_ready_temp_c
+     * between the runs (fan on full, if FAN_PIN is defined)
+     */
+    enum class Batch : uint8_t
+    {
+        Off,     // Single run (or batch done/aborted)
+        Running, // Profile of a batch is running
+        Cooling, // Wait for the plate to cool down below the ready temp
+        Ready,   // Ready, load next board (and push to start)
+    };
+
+    /*
+     * Preheat & hold between the runs (standby): Regulate the plate at the first soak temp of the profile
+     * or at Config::standby_temp_c. A profile started from hold skips its segments up to (incl.) the hold temp.
+     */
+    enum class Hold : uint8_t
+    {
+        Off,
+        Soak,   // First HoldTime (soak) temp of the profile
+        Custom, // Config::standby_temp_c
     };
 
+    typedef struct
+    {
+        SegmentType type;
+        uint8_t temp_c; // Target resp. hold temperature
+        uint8_t arg;    // RampRate/CoolRate: Rate (1/10 °C per s), Dwell: Threshold (°C)
+        uint8_t time_s; // HoldTime/Dwell: Duration, others: Timeout (0 = none)
+    } Segment;
+
+    /*
+     * Compile time derived from the segment table (see ProfileTable in Profile.cpp)
+     */
+    typedef struct
+    {
+        uint16_t step_dc; // RampRate/CoolRate: Setpoint change per PROFILE_STEP_MS
+        uint16_t invRate; // RampRate/CoolRate: (1 << PROFILE_RATE_SHIFT) / rate, so that time = delta * invRate >> PROFILE_RATE_SHIFT
+        uint16_t after_s; // Nominal duration of all following segments
+    } SegmentPlan;
+
     Profile() {};
     void loop();
 
+    const RunMetrics &getRunMetrics() { return _metrics; };
+    bool hasRunMetrics() { return _metrics.duration_s; };
+    void printRunMetrics(const RunMetrics &m);
+
     short getSecondsLeft();
 
     bool isStandBy();
+    bool isAboveMaxTemp(); // Peak of the selected profile above max_temp_c, refused by startProfile()
+    static uint8_t getLiquidus(Profiles p) { return pgm_read_byte(&_profileSegments[p].liquidus_c); }; // 0 for Manual
+    bool isRunning() { return _profileStart_ms; };
+
+    bool isHolding() { return _holdTemp_c; };
+    uint8_t getHoldTemp() { return _holdTemp_c; };
+
+    Batch getBatch() { return _batch; };
+    uint8_t getBatchDone() { return _batchDone; }; // Completed runs of the (last) batch
 
     bool startProfile();
-    void stopProfile();
+    bool stopProfile();
+    bool consumeFinished();
 
 private:
-    typedef struct
-    {
-        uint16_t time_s; // After n seconds...
-        uint16_t temp_c; // reach this target temp
-    } ProfileTimeTarget;
+    friend class Benchmark; // See main_bench.cpp
 
     typedef struct
     {
-        uint8_t length; // length of (the next) timeTargets[]
-        ProfileTimeTarget *timeTargets;
-        uint16_t duration_s; // Duration (s) of the complete profile (last entry)
-    } ProfileTimeTargets;
-
-    // FIXME: Should be possible directly within _profile2timeTargets
-    const ProfileTimeTargets _profileTimeTarget_Sn42Bi576Ag04 = {4, (ProfileTimeTarget[]){{90, 90}, {180, 130}, {210, 138}, {240, 165}}, 240};
-    const ProfileTimeTargets _profileTimeTarget_tSn965Ag30Cu05 = {4, (ProfileTimeTarget[]){{90, 150}, {180, 175}, {210, 217}, {240, 249}}, 240};
-    ProfileTimeTargets const *_profile2timeTargets[3] = {
-        [Manual] = nullptr,
-        [Sn42Bi576Ag04] = &_profileTimeTarget_Sn42Bi576Ag04,
-        [Sn965Ag30Cu05] = &_profileTimeTarget_tSn965Ag30Cu05,
-    };
+        const Segment *segments; // PROGMEM
+        const SegmentPlan *plans; // PROGMEM
+        uint8_t length;
+        uint8_t liquidus_c; // Liquidus temperature of the solder paste (for the run metrics), threshold of the Dwell segment
+        uint8_t peak_c;     // Max. segment temperature
+    } ProfileSegments;
+
+    static const ProfileSegments _profileSegments[3]; // PROGMEM
+
+    uint32_t _nextStep_ms = 0, _profileStart_ms = 0, _segmentStart_ms = 0;
+
+    RunMetrics _metrics = {};
+    int16_t _startTemp_dc, _lastTemp_dc;
+
+    uint32_t _startOnTime_ms[HOTPLATE_CHANNELS], _segmentOnTime_ms; // SSR on-time at run resp. segment start
+    uint32_t _startSwitches;
+    uint32_t _energyOnTime_ms, _energyRest; // Energy metering: Accounted SSR on-time, and remainder (ms * 10 W) below 1/10 Wh
+
+    uint8_t _segment = 0;       // Index of the active segment
+    uint16_t _segmentSteps = 0; // PROFILE_STEP_MS steps within the active segment
+    int16_t _setpoint_dc = 0;   // Profile curve (segment interpreter setpoint)
+    uint16_t _dwell_s = 0;      // Dwell: Time above threshold
+    bool _finished = false;     // Ran to the end, see consumeFinished()
+    bool _printMetrics = false; // Run got stopped, print the run metrics within loop()
+
+    uint8_t _holdTemp_c = 0; // Preheat & hold temp between the runs, 0 = not holding
 
-    uint32_t _nextInterval_ms = 0, _profileStart_ms = 0;
+    Batch _batch = Batch::Off;
+    uint8_t _batchDone = 0;
 
-    uint16_t getTempTarget();
+    bool getSegment(uint8_t idx, Segment &seg, SegmentPlan *plan = nullptr);
+    void runSegment(uint32_t now);
+    void finishProfile();
+    void seekSegment(int16_t temp_dc, bool held);
+    void startHold();
+    void batchLoop();
+    void setFan(uint8_t duty);
+    void dispatchBoundChannels(Hotplate::Event ev);
+    void updateMetrics(uint32_t now);
+    void updateSegmentDuty(uint32_t now);
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,29 @@
+#ifndef Rotary_h
+#define Rotary_h
+
+#include <Arduino.h>
+
+#define ROTARY_TRANSITIONS_PER_DETENT 4 // EC11: One full quadrature cycle per detent
+
+/*
+ * Table driven quadrature decoder of the rotary encoder A/B channels.
+ * Invalid transitions (both channels changed = missed edge or bounce) get rejected, and contact bounce
+ * of a single channel cancels out (+1/-1), thus a detent step gets only reported after a full valid cycle.
+ * Fast spins get accelerated by a velocity based step multiplier (see Config::Conf::rotary_accel_*).
+ */
+class Rotary
+{
+public:
+    void begin(uint8_t ab) { _ab = ab & 0x03; };
+    int8_t update(uint8_t ab, uint32_t now_ms);
+
+private:
+    uint8_t _ab = 0x03; // Last A/B state (A = bit1, B = bit0). Idle high due to pull ups
+    int8_t _transitions = 0;
+    int8_t _lastDir = 0;
+    uint32_t _lastDetent_ms = 0;
+
+    uint8_t getMultiplier(int8_t dir, uint32_t now_ms);
+};
+
+#endif
@@ -0,0 +1,67 @@
+#ifndef RunLog_h
+#define RunLog_h
+
+#include <Arduino.h>
+#include "Profile.hpp"
+
+#define RUNLOG_EEPROM_START 64 // Behind Config::EEPConfig
+#define RUNLOG_SLOT_SIZE 128   // Header + samples of one run
+#define RUNLOG_SLOTS ((E2END + 1 - RUNLOG_EEPROM_START) / RUNLOG_SLOT_SIZE)
+#define RUNLOG_SWITCHES_ADDR (RUNLOG_EEPROM_START - sizeof(uint32_t) * HOTPLATE_CHANNELS) // Lifetime SSR switch counts
+#define RUNLOG_SWITCHES_SAVE_STEP 256 // Save the lifetime SSR switch count every n switch-on's (while heating)
+
+#define RUNLOG_SAMPLE_INTERVAL_MS 4000 // One sample (= max. 2 EEPROM byte writes) per interval. 99 samples = ~6.5 min. per run
+#define RUNLOG_TEMP_STEP_C 2           // Temperature resolution of a delta nibble, i.e. -16..+14 °C per sample
+#define RUNLOG_DUTY_MAX 14             // Duty nibble range 0..14, so that a sample never becomes RUNLOG_END_MARK
+#define RUNLOG_END_MARK 0xFF
+
+/*
+ * Ring buffer log of the last RUNLOG_SLOTS profile runs within the EEPROM (behind the config).
+ *
+ * Each run occupies one slot: A header with sequence number, start temperature and (at run end) the run metrics,
+ * followed by delta encoded samples. One sample byte = temperature delta (high nibble, signed, RUNLOG_TEMP_STEP_C units)
+ * and SSR duty (low nibble, 0..RUNLOG_DUTY_MAX). Samples get appended during the run, each followed by an end mark,
+ * so there's no per-sample header update and the EEPROM wear stays low.
+ *
+ * The lifetime SSR switch-on count per channel (relay wear indicator) sits in front of the slots. It gets saved
+ * independent of profile runs: Every RUNLOG_SWITCHES_SAVE_STEP switch-on's, and whenever the channel got stopped
+ * (standby or fault) in any mode. So at most RUNLOG_SWITCHES_SAVE_STEP switches get lost by a power cut.
+ */
+class RunLog
+{
+public:
+    void setup();
+    void loop();
+
+    void print();
+
+    uint32_t getLifetimeSwitches(uint8_t channel);
+
+private:
+    typedef struct
+    {
+        uint16_t seq; // Run sequence number, 0xFFFF = empty slot
+        uint8_t startTemp_c;
+        uint8_t complete; // RUNLOG_END_MARK until the run got finished (and the metrics got written)
+        Profile::RunMetrics metrics;
+    } Header;
+
+    uint16_t _nextSeq = 0, _sampleAddr;
+    uint8_t _nextSlot = 0, _slot;
+    int16_t _logTemp_c; // Temperature as reconstructed from the logged deltas
+    uint32_t _nextSample_ms;
+    bool _logging = false;
+    uint32_t _switchesBase[HOTPLATE_CHANNELS];  // Lifetime SSR switch-on's at startup
+    uint32_t _switchesSaved[HOTPLATE_CHANNELS]; // Lifetime SSR switch-on's as saved in EEPROM
+
+    void saveSwitches();
+
+    uint16_t slotAddr(uint8_t slot) { return RUNLOG_EEPROM_START + slot * RUNLOG_SLOT_SIZE; };
+
+    void start();
+    void writeSample();
+    void finish();
+    void printSlot(uint8_t slot);
+};
+
+#endif
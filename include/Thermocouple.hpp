@@ -1,24 +1,39 @@
 #ifndef Thermocouple_h
 #define Thermocouple_h
 
-#include <max6675.h>
+#include "ThermocoupleDriver.hpp"
 
-#define TC_MAX_READ_INTERVAL_MS 220 // MAX6675 module can read values every 170-220 ms
-#define TC_AVG_SAMPLES 5            // How much samples to use for average calculation. 5 sample @ 220ms result in a max temp delay of approx. 1s
+/*
+ * Converter selection via build flag: -D TC_MAX31855 or -D TC_MAX31856, default MAX6675.
+ * The faster converters allow a shorter PID_SAMPLE_MS (see Hotplate.hpp).
+ */
+#if defined TC_MAX31856
+typedef Max31856 TcDriver;
+#elif defined TC_MAX31855
+typedef Max31855 TcDriver;
+#else
+typedef Max6675 TcDriver;
+#endif
+
+#define TC_MAX_READ_INTERVAL_MS TcDriver::CONVERSION_MS // Conversion time of the converter, i.e. MAX6675 = 170-220 ms
+#define TC_AVG_SAMPLES 5                                // How much samples to use for average calculation. 5 sample @ 220ms result in a max temp delay of approx. 1s
 
 /*
- * Simple Thermocouple wrapper around MAX6675. Mainly to be open for other TC controller...
- * Later, one might implement a bridge pattern
+ * Simple Thermocouple wrapper around the (compile time selected) converter driver
  */
 class Thermocouple
 {
 public:
-    Thermocouple(const int8_t pin_CLK, const int8_t pin_CS, const int8_t pin_DO);
+    Thermocouple(const int8_t pin_CS); // CLK/DO/DI are compile time pins, shared by all channels
+    void begin() { _Tc.begin(); };
     float getTemperature();
     float getTemperatureAverage();
+    uint8_t getFault() { return _Tc.getFault(); };
 
 private:
-    MAX6675 _Tc;
+    friend class Benchmark; // See main_bench.cpp
+
+    TcDriver _Tc;
     uint32_t _nextRead_ms = 0;
     float _lastTemp, _avgTemp;
 
@@ -0,0 +1,120 @@
+#ifndef ThermocoupleDriver_h
+#define ThermocoupleDriver_h
+
+#include <Arduino.h>
+
+/*
+ * Thermocouple converter drivers (policy classes). The driver gets selected at compile time (see Thermocouple.hpp),
+ * thus there's no virtual call (and no vtable in RAM). Every driver provides:
+ *   CONVERSION_MS        Min. time between two reads (conversion time of the chip)
+ *   begin()              Init pins (and chip registers)
+ *   readCelsius()        Thermocouple temperature, NAN on fault
+ *   getFault()           Fault bits of the last read (chip specific), 0 = ok
+ *
+ * All of them use a bit-banged SPI (read only, except MAX31856) on the compile time pins TC_CLK_PIN, TC_DO_PIN
+ * and TC_DI_PIN (see main.hpp and FastGpio.hpp), shared by all channels. Only CS is per channel.
+ * Host mocks of the chips (pin level) can be found in replay/shim/ThermocoupleMock.h
+ */
+
+class SoftSpiDevice
+{
+public:
+    SoftSpiDevice(int8_t pin_CS) : _cs(pin_CS) {}
+
+protected:
+    const int8_t _cs;
+
+    void beginSpi(bool withDi);
+    void select(bool sel) { digitalWrite(_cs, sel ? LOW : HIGH); };
+    uint32_t readMode0(uint8_t bits);
+    uint8_t transferMode1(uint8_t out);
+};
+
+/*
+ * MAX6675: 12 bit, 0.25 °C, 0..1024 °C, 170-220 ms conversion
+ */
+class Max6675 : public SoftSpiDevice
+{
+public:
+    static const uint16_t CONVERSION_MS = 220;
+    static const uint8_t FAULT_OPEN = 0x04; // D2 = Thermocouple input open
+
+    Max6675(int8_t pin_CS) : SoftSpiDevice(pin_CS) {}
+
+    void begin() { beginSpi(false); };
+    float readCelsius();
+    uint8_t getFault() { return _fault; };
+
+    static float decode(uint16_t frame) { return (frame & FAULT_OPEN) ? NAN : (frame >> 3) * 0.25; };
+
+private:
+    uint8_t _fault = 0;
+};
+
+/*
+ * MAX31855: 14 bit, 0.25 °C, -270..1800 °C, 100 ms conversion, with cold-junction temperature
+ */
+class Max31855 : public SoftSpiDevice
+{
+public:
+    static const uint16_t CONVERSION_MS = 100;
+    static const uint8_t FAULT_OPEN = 0x01;   // D0 = Open circuit
+    static const uint8_t FAULT_SHORT_GND = 0x02;
+    static const uint8_t FAULT_SHORT_VCC = 0x04;
+
+    Max31855(int8_t pin_CS) : SoftSpiDevice(pin_CS) {}
+
+    void begin() { beginSpi(false); };
+    float readCelsius();
+    float getColdJunction() { return _coldJunction; };
+    uint8_t getFault() { return _fault; };
+
+    static float decode(uint32_t frame) { return (frame & 0x00010000) ? NAN : ((int32_t)frame >> 18) * 0.25; };
+    static float decodeColdJunction(uint32_t frame) { return ((int16_t)frame >> 4) * 0.0625; };
+
+private:
+    float _coldJunction = NAN;
+    uint8_t _fault = 0;
+};
+
+/*
+ * MAX31856: 19 bit, 0.0078125 °C, 100 ms conversion (auto conversion mode, 60 Hz filter, 1 sample),
+ * with cold-junction and fault status registers. Needs the DI pin for the register setup.
+ */
+class Max31856 : public SoftSpiDevice
+{
+public:
+    static const uint16_t CONVERSION_MS = 100;
+
+    enum Register : uint8_t
+    {
+        CR0 = 0x00,
+        CR1 = 0x01,
+        MASK = 0x02,
+        CJTH = 0x0A, // Cold-junction temperature, followed by CJTL
+        LTCBH = 0x0C, // Linearized thermocouple temperature, followed by LTCBM, LTCBL and SR
+        SR = 0x0F,    // Fault status register
+    };
+
+    static const uint8_t CR0_AUTOCONVERT = 0x80;
+    static const uint8_t CR0_OCFAULT = 0x10;  // Open circuit detection (Rs < 5 kOhm)
+    static const uint8_t CR1_TYPE_K = 0x03;   // 1 sample, type K
+    static const uint8_t WRITE = 0x80;        // Address bit for register writes
+
+    Max31856(int8_t pin_CS) : SoftSpiDevice(pin_CS) {}
+
+    void begin();
+    float readCelsius();
+    float getColdJunction();
+    uint8_t getFault() { return _fault; };
+
+    static float decode(uint8_t h, uint8_t m, uint8_t l) { return ((int32_t)((uint32_t)h << 24 | (uint32_t)m << 16 | (uint32_t)l << 8) >> 13) * 0.0078125; };
+
+private:
+    uint8_t _fault = 0;
+
+    void readRegisters(uint8_t reg, uint8_t *buf, uint8_t len);
+    void writeRegister(uint8_t reg, uint8_t value);
+};
+
+#endif
@@ -4,55 +4,155 @@
 #include <Arduino.h>
 #include <U8g2lib.h>
 #include "Hotplate.hpp"
+#include "Profile.hpp"
 
 #define INTERVAL_DISP 100 // (max) Display refresh rate (if dirty)
 
+#define UI_INPUT_MAX_DIGITS 8 // Max. int + dec digits of a digit input widget
+#define UI_LIST_ROWS 3        // Visible entries of a selection list (below the title)
+#define UI_ENTRY_SIZE 19      // Selection list entry (longest entry + '\0'), fixed width flash resident lists
+#define UI_TITLE_SIZE 32      // Setup screen title (incl. '\n' and '\0')
+#define UI_LINE_HEIGHT 13     // Line height of std font
+#define UI_MODE_NONE 0xFF     // No pending mode change
+
+#define UI_TILE_ROWS 8             // Display height in tiles (8 pixel rows)
+#define UI_MAIN_TILES_TITLE 0x03   // Main screen tile rows (bit mask) of the 1st row (state title, profile)
+#define UI_MAIN_TILES_ROW2 0x0E    // 2nd row (target, time left, hints)
+#define UI_MAIN_TILES_ROW3 0x38    // 3rd row (controller output)
+#define UI_MAIN_TILES_TEMP 0xE0    // Temperature, SSR power symbol, unit
+#define UI_MAIN_TILES_ALL 0xFF
+
+#define UI_GRAPH_TOP 16     // Graph screen: Plot area below the header (tile rows 2..7)
+#define UI_GRAPH_HEIGHT 48
+
 class Ui
 {
 public:
     enum Mode
     {
         Main,
-        Setup
+        Setup,
+        Summary, // Post-run summary (run metrics)
+        Graph,   // Temperature vs. profile curve of the (last) run
+    };
+
+    /*
+     * User inputs, which get queued (from ISR) via input() and consumed by the next loop()
+     */
+    enum class Input : uint8_t
+    {
+        Plus,
+        Minus,
+        Push,
+        LongPush,
     };
 
     Ui();
     void setup();
     void loop();
 
-    void changeMode(Mode nextMode) { _mode = nextMode; };
+    void requestMode(Mode nextMode);
+    bool isMode(Mode checkMode) { return _mode == checkMode; };
+
+    void input(Input in);
+
+    uint8_t getChannel() { return _channel; }; // Channel shown on the main screen and controlled by the knob
 
 private:
-    typedef struct MainScreenCrcData
+    friend class Benchmark; // See main_bench.cpp
+
+    /*
+     * Main screen values, as last drawn. A changed value marks the tile rows of its field for redraw
+     */
+    typedef struct MainScreenFields
     {
-        Hotplate::Mode hpMode;
-        bool hpPower;
-        uint16_t hpSetpoint;
         Hotplate::State hpState;
+        Profile::Profiles profile;
+        bool standBy;
+        Profile::Batch batch;
+        uint8_t batchDone;
+        uint16_t hpSetpoint;
         short profileSecLeft;
-        float tcTempAvg;
-    } MainScreenCrcData;
+        Hotplate::Control hpControl;
+        uint16_t hpOutput;
+        int16_t temp_dc; // INT16_MIN = sensor fault
+        bool hpPower;
+    } MainScreenFields;
+
+    /*
+     * Setup screens. Each screen is one of the (non-blocking) widgets: List, Value, Digits or Message
+     */
+    enum class SetupScreen : uint8_t
+    {
+        Menu,    // List
+        Profile, // List
+        ProfileStart, // List
+        StandbyHold,  // List
+        StandbyTemp,  // Value
+        SsrType, // List
+        HeaterPower, // Value
+        MaxTemp, // Value
+        SlewRate, // Value
+        BangOn,  // Value
+        BangOff, // Value
+        BatchRuns,  // Value
+        BatchReady, // Value
+        PidKp,   // Digits
+        PidKi,   // Digits
+        PidKd,   // Digits
+        Memory,  // Message
+#if HOTPLATE_CHANNELS > 1
+        Channel, // List
+#endif
+    };
+
+    typedef struct SetupState
+    {
+        SetupScreen screen;
+        uint8_t cursor; // List: Selected entry, Digits: Edit position
+        uint8_t value;  // Value: Edited (not yet committed) value
+        char digits[UI_INPUT_MAX_DIGITS + 2]; // Digits: Edited digits + '.' + '\0'
+        bool dirty; // Also used by the summary screen
+    } SetupState;
 
     U8G2_SSD1306_128X64_NONAME_1_HW_I2C u8g2;
     Mode _mode = Mode::Main;
+    SetupState _setup;
+    uint8_t _channel = 0;
+
+    volatile int8_t _pendingSteps = 0; // Plus/Minus inputs, queued by input()
+    volatile bool _pendingPush = false;
+    volatile bool _pendingLongPush = false;
+    volatile uint8_t _pendingMode = UI_MODE_NONE; // Mode change, queued by requestMode()
 
     uint32_t _nextInterval_ms = 0;
-    uint32_t _lastMainScreenCrc;
+    MainScreenFields _mainScreen;
+    uint8_t _mainScreenDirty = UI_MAIN_TILES_ALL; // Tile rows to redraw regardless of the values
+    uint8_t _graphRevision; // Graph::getRevision() as last drawn
+
+    void changeMode(Mode nextMode);
 
     void displayMainScreen();
     void displaySetupScreen();
+    void displaySummaryScreen();
+    void displayGraphScreen();
+
+    void handleSetupInput(int8_t steps, bool push);
+    void enterSetupScreen(SetupScreen screen);
+    void selectSetupMenu(uint8_t entry);
 
-    void inputBangValues();
-    void inputMaxTemp();
-    void inputPidConstants();
-    void inputReflowProfile();
-    void inputSsrType();
+    // Strings (title, entries, pre, post) are flash resident (PSTR(), PROGMEM)
+    void drawSelectionList(const char *title, const char *entries, uint8_t entrySize, uint8_t numEntries);
+    void drawInputValue(const char *title, const char *pre, const char *post);
+    void drawInputDigits(const char *title, const char *pre);
+    void drawMemoryInfo();
 
     void setStdFont();
 
-    void userInterfaceInputDouble(const char *title, const char *pre, double *value, uint8_t numInt, uint8_t numDec, const char *post);
+    void valueToDigits(double value, uint8_t numInt, uint8_t numDec);
+    double digitsToValue();
 
     u8g2_uint_t drawUTF8Lines(u8g2_uint_t x, u8g2_uint_t y, u8g2_uint_t w, u8g2_uint_t line_height, const char *s);
 };
 
-#endif
\ No newline at end of file
+#endif
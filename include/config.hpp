@@ -3,7 +3,7 @@
 
 #include "Profile.hpp"
 
-#define CONFIG_VERSION 8 // Change to force reload of default config even if config structure hasn't changed
+#define CONFIG_VERSION 16 // Change to force reload of default config even if config structure hasn't changed
 
 namespace Config
 {
@@ -12,7 +12,7 @@ namespace Config
     {
         bool disp_unit_c = true; // °C/F
 
-        uint8_t max_temp_c = 200; // Max. possible (or allowed) heater temperature (*C)
+        uint8_t max_temp_c = 200; // Max. possible (or allowed) heater temperature (*C). Over-temp. fault at + HOTPLATE_OVERTEMP_MARGIN_C
         
         uint16_t pid_pwm_window_ms = 5000; // For easiest handling, this might/should be approx. system-temp-delay time long
 
@@ -20,12 +20,25 @@ namespace Config
         double pid_Ki = 2.0;
         double pid_Kd = 422.0;
 
+        uint8_t setpoint_slew_cs = 0; // Max. rate (°C/s) the PID setpoint follows a setpoint change, 0 = unlimited
+
         uint8_t pid_bangOn_temp_c = 50;
         uint8_t pid_bangOff_temp_c = 5;
 
         Profile::Profiles profile = Profile::Profiles::Manual;
+        bool profile_warm_start = true; // Start the profile at the segment which matches the current plate temp (skip preheat/soak on a warm plate)
+        Profile::Hold standby_hold = Profile::Hold::Off; // Preheat & hold between the profile runs
+        uint8_t standby_temp_c = 100;                    // Hold temp if standby_hold = Custom
+        uint8_t batch_runs = 1;          // Profile runs per batch, <= 1 = single run
+        uint8_t batch_ready_temp_c = 60; // Batch: Next run may start if the plate cooled down below
 
         bool ssr_active_low = true; // SSR = on @ low level = true, or on high level
+        uint8_t heater_10w = 40;    // Heater power per channel (10 W units), for the run energy metering
+
+        uint8_t rotary_accel_medium_ms = 80; // Detent interval (ms) below which a detent moves the setpoint by rotary_accel_medium_steps
+        uint8_t rotary_accel_medium_steps = 5;
+        uint8_t rotary_accel_fast_ms = 30;   // Detent interval (ms) below which a detent moves the setpoint by rotary_accel_fast_steps
+        uint8_t rotary_accel_fast_steps = 10; // Set both *_steps to 1 to disable the acceleration
 
         uint8_t version = CONFIG_VERSION;
     };
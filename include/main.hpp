@@ -5,14 +5,22 @@
 #include "Thermocouple.hpp"
 #include "Hotplate.hpp"
 #include "Profile.hpp"
+#include "RunLog.hpp"
+#include "ControlTrace.hpp"
+#include "Fan.hpp"
+#include "Graph.hpp"
 
 //#define DEBUG_SERIAL
 //#define DEBUG_UI_SERIAL
+#define IDLE_SLEEP // MCU idle sleep between the loop() runs (wakes on millis() tick, encoder and serial RX)
+#define LIVE_GRAPH    // Setup "Graph" screen of the (last) profile run. Comment out to free ~200 byte RAM (see Graph.hpp)
+#define CONTROL_TRACE // RAM control trace, serial commands F/T. Comment out to free ~200 byte RAM (see ControlTrace.hpp)
 
-// Thermocouple (MAX6675) pins
+// Thermocouple (MAX6675/MAX31855/MAX31856) pins
 #define TC_DO_PIN 6
 #define TC_CS_PIN 7
 #define TC_CLK_PIN 8
+#define TC_DI_PIN 10 // MAX31856 only (register setup)
 
 // Hot-LED
 #define LED_PIN 4
@@ -20,6 +28,14 @@
 // Hotplate's SSR
 #define SSR_Pin 5
 
+// 2nd channel, if HOTPLATE_CHANNELS > 1 (shares TC_DO_PIN and TC_CLK_PIN)
+#define TC2_CS_PIN 9
+#define SSR2_PIN 3
+#define HOTPLATE2_PROFILE_OFFSET_C HOTPLATE_PROFILE_UNBOUND // Setpoint offset to the reflow profile (i.e. -40 for a preheat zone), or unbound
+
+// Cooling fan/blower (SSR or MOSFET, closed loop CoolRate segments and batch cool down), optional. Uncomment if wired
+//#define FAN_PIN 2
+
 // Rotary knob
 #define ROTARY_PORT_CMD PINC // All rotary pins need to be connected to this Port
 
@@ -38,8 +54,18 @@
 #define VERSION_TEXT "0.5.0"
 
 extern Ui ui;
-extern Thermocouple thermocouple;
-extern Hotplate hotplate;
+extern Thermocouple thermocouples[HOTPLATE_CHANNELS];
+extern Hotplate hotplates[HOTPLATE_CHANNELS];
 extern Profile profile;
+extern RunLog runLog;
+#ifdef CONTROL_TRACE
+extern ControlTrace controlTrace;
+#endif
+#ifdef LIVE_GRAPH
+extern Graph graph;
+#endif
+#ifdef FAN_PIN
+extern Fan<FAN_PIN> fan;
+#endif
 
 #endif
\ No newline at end of file
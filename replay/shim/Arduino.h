@@ -0,0 +1,102 @@
+/*
+ * Minimal host (native) replacement of the Arduino API, for the trace replay harness (env:REPLAY).
+ * Only what's used by the control path (Hotplate, Profile, Thermocouple(Driver), Config, AutoPID) is covered.
+ * Time and pin states are owned by the harness, see src/main_replay.cpp.
+ */
+#ifndef Arduino_h
+#define Arduino_h
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+typedef uint8_t byte;
+typedef bool boolean;
+
+#define HIGH 0x1
+#define LOW 0x0
+#define INPUT 0x0
+#define OUTPUT 0x1
+#define INPUT_PULLUP 0x2
+
+#define HEX 16
+#define DEC 10
+
+#define PROGMEM
+#define PSTR(s) (s)
+#define F(s) (s)
+#define pgm_read_byte(addr) (*(const uint8_t *)(addr))
+#define pgm_read_word(addr) (*(const uint16_t *)(addr))
+#define pgm_read_dword(addr) (*(const uint32_t *)(addr))
+#define pgm_read_ptr(addr) (*(void *const *)(addr))
+#define memcpy_P memcpy
+
+#define noInterrupts()
+#define interrupts()
+
+#ifndef min
+#define min(a, b) ((a) < (b) ? (a) : (b))
+#endif
+#ifndef max
+#define max(a, b) ((a) > (b) ? (a) : (b))
+#endif
+#define constrain(amt, low, high) ((amt) < (low) ? (low) : ((amt) > (high) ? (high) : (amt)))
+
+#define SHIM_NUM_PINS 32
+
+namespace Shim
+{
+    extern uint32_t millis_ms;                   // Simulated time
+    extern uint8_t pinLevel[SHIM_NUM_PINS];      // Last digitalWrite() level per pin
+    extern uint32_t pinToggles[SHIM_NUM_PINS];   // Level changes per pin
+    extern void (*pinWriteHook)(uint8_t pin, uint8_t val); // Pin level device mocks, see ThermocoupleMock.h
+}
+
+inline unsigned long millis() { return Shim::millis_ms; }
+inline unsigned long micros() { return Shim::millis_ms * 1000UL; }
+inline void delay(unsigned long ms) { Shim::millis_ms += ms; }
+inline void delayMicroseconds(unsigned int) {}
+
+inline void pinMode(uint8_t, uint8_t) {}
+inline int digitalRead(uint8_t pin) { return pin < SHIM_NUM_PINS ? Shim::pinLevel[pin] : LOW; }
+inline void digitalWrite(uint8_t pin, uint8_t val)
+{
+    if (pin >= SHIM_NUM_PINS)
+        return;
+    if (Shim::pinLevel[pin] != val)
+        Shim::pinToggles[pin]++;
+    Shim::pinLevel[pin] = val;
+    if (Shim::pinWriteHook)
+        Shim::pinWriteHook(pin, val);
+}
+
+/*
+ * Serial output of the firmware is swallowed, the harness owns stdout
+ */
+class Print
+{
+public:
+    template <typename T>
+    size_t print(T, int = DEC) { return 0; }
+    template <typename T>
+    size_t println(T, int = DEC) { return 0; }
+    size_t println() { return 0; }
+    size_t write(uint8_t) { return 1; }
+    size_t write(const uint8_t *, size_t size) { return size; }
+};
+
+class HardwareSerial : public Print
+{
+public:
+    void begin(unsigned long) {}
+    void flush() {}
+    int available() { return 0; }
+    int read() { return -1; }
+};
+
+extern HardwareSerial Serial;
+
+#endif
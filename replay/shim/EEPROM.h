@@ -0,0 +1,40 @@
+/*
+ * Host replacement of the AVR EEPROM library for the trace replay harness (env:REPLAY)
+ */
+#ifndef EEPROM_h
+#define EEPROM_h
+
+#include <Arduino.h>
+
+#define SHIM_EEPROM_SIZE 1024
+
+namespace Shim
+{
+    extern uint8_t eeprom[SHIM_EEPROM_SIZE];
+}
+
+struct EEPROMClass
+{
+    uint8_t read(int idx) { return Shim::eeprom[idx]; }
+    void write(int idx, uint8_t val) { Shim::eeprom[idx] = val; }
+    void update(int idx, uint8_t val) { Shim::eeprom[idx] = val; }
+    uint16_t length() { return SHIM_EEPROM_SIZE; }
+
+    template <typename T>
+    T &get(int idx, T &t)
+    {
+        memcpy(&t, &Shim::eeprom[idx], sizeof(T));
+        return t;
+    }
+
+    template <typename T>
+    const T &put(int idx, const T &t)
+    {
+        memcpy(&Shim::eeprom[idx], &t, sizeof(T));
+        return t;
+    }
+};
+
+extern EEPROMClass EEPROM; // See main_replay.cpp
+
+#endif
@@ -0,0 +1,192 @@
+/*
+ * Host (pin level) mocks of the thermocouple converters, for the trace replay harness (env:REPLAY).
+ * They get driven by the unmodified drivers (src/ThermocoupleDriver.cpp) via digitalWrite()/digitalRead()
+ * and convert the temperature provided by the harness (Shim::tcTemp_c) with the resolution and frame
+ * format of the real chip. Faults can be injected via the public members.
+ */
+#ifndef ThermocoupleMock_h
+#define ThermocoupleMock_h
+
+#include <Arduino.h>
+
+namespace Shim
+{
+    extern float tcTemp_c;
+
+    class SpiChipMock
+    {
+    public:
+        SpiChipMock(uint8_t pin_CLK, uint8_t pin_CS, uint8_t pin_DO, uint8_t pin_DI = SHIM_NUM_PINS)
+            : _clk(pin_CLK), _cs(pin_CS), _do(pin_DO), _di(pin_DI) {}
+        virtual ~SpiChipMock() {}
+
+        void install()
+        {
+            active() = this;
+            pinWriteHook = &SpiChipMock::onPinWrite;
+        }
+
+    protected:
+        virtual void onSelect() = 0;
+        virtual void onClock(bool rising) = 0;
+
+        void setDo(bool level) { pinLevel[_do] = level ? HIGH : LOW; }
+        bool getDi() { return _di < SHIM_NUM_PINS && pinLevel[_di]; }
+
+    private:
+        const uint8_t _clk, _cs, _do, _di;
+        bool _selected = false, _clkLevel = false;
+
+        static SpiChipMock *&active()
+        {
+            static SpiChipMock *mock = nullptr;
+            return mock;
+        }
+
+        static void onPinWrite(uint8_t pin, uint8_t val)
+        {
+            SpiChipMock *m = active();
+            if (pin == m->_cs)
+            {
+                m->_selected = (val == LOW);
+                if (m->_selected)
+                    m->onSelect();
+            }
+            else if (pin == m->_clk && (bool)val != m->_clkLevel)
+            {
+                m->_clkLevel = val;
+                if (m->_selected)
+                    m->onClock(val);
+            }
+        }
+    };
+
+    /*
+     * Frame shift register of the read-only chips. First bit on CS low, next bits on falling CLK edge.
+     */
+    class FrameMock : public SpiChipMock
+    {
+    public:
+        using SpiChipMock::SpiChipMock;
+
+    protected:
+        uint32_t _frame = 0;
+        int8_t _bit = 0;
+
+        void load(uint32_t frame, uint8_t bits)
+        {
+            _frame = frame;
+            _bit = bits - 1;
+            setDo((_frame >> _bit) & 1);
+        }
+
+        void onClock(bool rising) override
+        {
+            if (!rising && _bit > 0)
+                setDo((_frame >> --_bit) & 1);
+        }
+    };
+
+    class Max6675Mock : public FrameMock
+    {
+    public:
+        using FrameMock::FrameMock;
+        bool open = false; // Thermocouple input open
+
+    protected:
+        void onSelect() override
+        {
+            uint16_t temp = constrain(tcTemp_c, 0, 1023.75) * 4;
+            load((uint32_t)temp << 3 | (open ? 0x04 : 0), 16);
+        }
+    };
+
+    class Max31855Mock : public FrameMock
+    {
+    public:
+        using FrameMock::FrameMock;
+        uint8_t fault = 0;        // OC = 0x01, SCG = 0x02, SCV = 0x04
+        float coldJunction_c = 25;
+
+    protected:
+        void onSelect() override
+        {
+            uint32_t temp = (int32_t)(constrain(tcTemp_c, -270, 1800) * 4) & 0x3FFF;
+            uint32_t cj = (int32_t)(coldJunction_c * 16) & 0x0FFF;
+            load(temp << 18 | (fault ? 0x00010000 : 0) | cj << 4 | fault, 32);
+        }
+    };
+
+    /*
+     * Register file with auto incremented address. SPI mode 1: Shift out on rising, sample DI on falling CLK edge.
+     */
+    class Max31856Mock : public SpiChipMock
+    {
+    public:
+        using SpiChipMock::SpiChipMock;
+        uint8_t fault = 0; // SR register
+        float coldJunction_c = 25;
+        uint8_t regs[16] = {};
+
+    protected:
+        uint8_t _addr = 0, _in = 0, _out = 0, _bits = 0;
+        bool _addrPhase = true, _write = false;
+
+        void onSelect() override
+        {
+            if (regs[0x00] & 0x80) // CR0 auto conversion
+            {
+                int32_t ltc = (int32_t)(tcTemp_c * 128) * 32; // 19 bit within LTCBH..LTCBL
+                int16_t cj = (int16_t)(coldJunction_c * 64) * 4;
+                regs[0x0A] = (uint16_t)cj >> 8;
+                regs[0x0B] = cj & 0xFF;
+                regs[0x0C] = (uint32_t)ltc >> 16;
+                regs[0x0D] = (uint32_t)ltc >> 8;
+                regs[0x0E] = ltc & 0xFF;
+                regs[0x0F] = fault;
+            }
+            _addrPhase = true;
+            _bits = 0;
+            _in = 0;
+            _out = 0;
+        }
+
+        void onClock(bool rising) override
+        {
+            if (rising)
+            {
+                setDo(_out & (0x80 >> _bits));
+                return;
+            }
+            _in = (_in << 1) | getDi();
+            if (++_bits < 8)
+                return;
+
+            if (_addrPhase)
+            {
+                _addr = _in & 0x0F;
+                _write = _in & 0x80;
+                _addrPhase = false;
+            }
+            else
+            {
+                if (_write)
+                    regs[_addr] = _in;
+                _addr = (_addr + 1) & 0x0F;
+            }
+            _out = regs[_addr];
+            _bits = 0;
+            _in = 0;
+        }
+    };
+
+#if defined TC_MAX31856
+    typedef Max31856Mock TcMock;
+#elif defined TC_MAX31855
+    typedef Max31855Mock TcMock;
+#else
+    typedef Max6675Mock TcMock;
+#endif
+}
+
+#endif
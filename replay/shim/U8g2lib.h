@@ -0,0 +1,22 @@
+/*
+ * Host replacement of U8g2 for the trace replay harness (env:REPLAY).
+ * The Ui isn't part of the replay, only its declaration (via main.hpp) needs to compile.
+ */
+#ifndef U8G2LIB_HH
+#define U8G2LIB_HH
+
+#include <Arduino.h>
+
+typedef uint8_t u8g2_uint_t;
+
+#define U8G2_R0 0
+#define U8X8_PIN_NONE 255
+#define U8G2_FONT_SECTION(name)
+
+class U8G2_SSD1306_128X64_NONAME_1_HW_I2C
+{
+public:
+    U8G2_SSD1306_128X64_NONAME_1_HW_I2C(int, uint8_t) {}
+};
+
+#endif
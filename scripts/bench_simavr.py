@@ -0,0 +1,102 @@
+#!/usr/bin/env python3
+#
+# Cycle benchmark of the firmware hot paths (src/main_bench.cpp) within simavr.
+#
+# Builds env:BENCH, runs it within simavr (ATmega328P @ 16 MHz) and compares the reported cycles
+# against the stored baseline (scripts/bench_baseline.json). Fails if any benchmark got slower
+# than the allowed tolerance, or if there is no baseline yet (record one via --update on a machine
+# with the AVR toolchain and simavr, and commit it).
+#
+# Benchmarks (see src/main_bench.cpp): Hotplate::loop, digitalWrite vs. FastPin, Hotplate::setPower,
+# Led::blinkByTemp, Thermocouple::readTemperature, Profile::runSegment (segment interpreter step),
+# CRC32 and Ui::displayMainScreen (unchanged, temp. field, full)
+#
+# Usage:
+#   python3 scripts/bench_simavr.py [--no-build] [--update] [--tolerance PERCENT]
+#
+#   --update    Store the current results as new baseline (commit it together with the intended change)
+#
+import argparse
+import json
+import os
+import re
+import subprocess
+import sys
+
+PROJECT_DIR = os.path.normpath(os.path.join(os.path.dirname(os.path.abspath(__file__)), ".."))
+BASELINE = os.path.join(PROJECT_DIR, "scripts", "bench_baseline.json")
+ENV = "BENCH"
+BENCH_LINE = re.compile(r"BENCH (\S+) (\d+)")
+
+
+def build():
+    subprocess.check_call(["pio", "run", "-e", ENV], cwd=PROJECT_DIR)
+
+
+def run_simavr(timeout):
+    elf = os.path.join(PROJECT_DIR, ".pio", "build", ENV, "firmware.elf")
+    simavr = os.environ.get("SIMAVR", "simavr")
+    proc = subprocess.run([simavr, "-m", "atmega328p", "-f", "16000000", elf],
+                          stdout=subprocess.PIPE, stderr=subprocess.STDOUT,
+                          universal_newlines=True, timeout=timeout)
+    results = {}
+    done = False
+    for line in proc.stdout.splitlines():
+        found = BENCH_LINE.search(line)
+        if found:
+            results[found.group(1)] = int(found.group(2))
+        elif "BENCH done" in line:
+            done = True
+    if not done:
+        sys.exit("Benchmark didn't finish:\n" + proc.stdout)
+    return results
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__)
+    parser.add_argument("--no-build", action="store_true", help="Don't (re)build env:" + ENV)
+    parser.add_argument("--update", action="store_true", help="Store results as new baseline")
+    parser.add_argument("--tolerance", type=float, default=2.0, help="Allowed slow-down in percent (default 2)")
+    parser.add_argument("--timeout", type=int, default=120, help="simavr timeout in seconds")
+    args = parser.parse_args()
+
+    if not args.no_build:
+        build()
+    results = run_simavr(args.timeout)
+
+    try:
+        with open(BASELINE) as f:
+            baseline = json.load(f)
+    except OSError:
+        baseline = {}
+
+    failed = False
+    print("%-40s %10s %10s %8s" % ("Benchmark", "Baseline", "Cycles", "Diff"))
+    print("-" * 71)
+    for name, cycles in results.items():
+        base = baseline.get(name)
+        if base:
+            diff = 100.0 * (cycles - base) / base
+            mark = ""
+            if diff > args.tolerance:
+                mark = "  SLOWER"
+                failed = True
+            print("%-40s %10d %10d %+7.1f%%%s" % (name, base, cycles, diff, mark))
+        else:
+            print("%-40s %10s %10d %8s" % (name, "-", cycles, "new"))
+
+    if args.update:
+        with open(BASELINE, "w") as f:
+            json.dump(results, f, indent=4, sort_keys=True)
+            f.write("\n")
+        print("Baseline stored to " + os.path.relpath(BASELINE, PROJECT_DIR))
+        return 0
+    if not baseline:
+        print("No baseline (%s), record it via --update" % os.path.relpath(BASELINE, PROJECT_DIR))
+        return 1
+
+    return 1 if failed else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,173 @@
+#
+# Font subsetting: Regenerate the minimal U8g2 font arrays (assets/fonts/my_u8g2_font_*.hpp)
+# from their BDF sources, with only the glyphs which are actually used by the UI.
+#
+# The glyphs of the std. font get collected from the string and char literals of the UI sources
+# (except includes, static_assert messages and Serial output), whereas fonts only used for
+# numbers (fur20) or symbols (open iconic) have a fixed glyph list.
+#
+# Usage:
+#   - Standalone: python3 scripts/font_subset.py [--check]
+#   - PlatformIO: extra_scripts = pre:scripts/font_subset.py (regenerates on every build if out of sync)
+#
+# Requires U8g2's bdfconv (https://github.com/olikraus/u8g2/tree/master/tools/font/bdfconv),
+# either within PATH or pointed to by the BDFCONV environment var.
+# Without bdfconv, out-of-sync fonts only get reported.
+#
+import os
+import re
+import shutil
+import subprocess
+import sys
+
+PROJECT_DIR = os.path.normpath(os.path.join(os.path.dirname(os.path.abspath(sys.argv[0])), ".."))
+
+# Sources which contain display strings
+UI_SOURCES = ["src/Ui.cpp", "src/Hotplate.cpp", "src/Profile.cpp", "include/main.hpp", "include/Format.hpp"]
+
+# Glyphs which might be produced by number formatting (formatNumber() in Format.hpp)
+NUMBER_GLYPHS = set(" -.0123456789")
+
+FONTS = [
+    {
+        "bdf": "7x13B.bdf",
+        "name": "my_u8g2_font_7x13B",
+        "options": ["-f", "1"],
+        "glyphs": NUMBER_GLYPHS,
+        "scan": True,
+        "log": "7x13B.bdf.conversion.txt",
+    },
+    {
+        "bdf": "fur20.bdf",
+        "name": "my_u8g2_font_fur20",
+        "options": ["-f", "1", "-b", "0"],
+        "glyphs": NUMBER_GLYPHS,
+        "scan": False,
+        "log": "fur20.bdf.comversion.txt",
+    },
+    {
+        "bdf": "open_iconic_embedded_2x.bdf",
+        "name": "my_u8g2_font_open_iconic_embedded_2x",
+        "options": ["-f", "1"],
+        "glyphs": set("C"),  # Power symbol
+        "scan": False,
+        "log": "open_iconic_embedded_2x.bdf.conversion.txt",
+    },
+]
+
+def font_dir():
+    return os.path.join(PROJECT_DIR, "assets", "fonts")
+
+
+TOKEN = re.compile(
+    r'(?P<comment>//[^\n]*|/\*.*?\*/)'
+    r'|(?P<str>"(?:[^"\\\n]|\\.)*")'
+    r"|(?P<chr>'(?:[^'\\\n]|\\.)+')"
+    r'|(?P<id>[A-Za-z_]\w*)'
+    r'|(?P<punct>\S)',
+    re.S,
+)
+# Calls whose string args never get displayed
+NON_UI_CALLS = {"static_assert", "Serial"}
+
+
+def tokens(text):
+    """(kind, value) of the C++ tokens, without comments. Literals keep their quotes"""
+    for t in TOKEN.finditer(text):
+        if t.lastgroup != "comment":
+            yield t.lastgroup, t.group()
+
+
+def skip_call(toks, i):
+    """Index after the closing parenthesis of the call whose name is at toks[i] (i.e. Serial.print(...))"""
+    while i < len(toks) and toks[i][1] != "(":
+        i += 1
+    depth = 0
+    for i in range(i, len(toks)):
+        depth += {"(": 1, ")": -1}.get(toks[i][1], 0)
+        if not depth:
+            return i + 1
+    return len(toks)
+
+
+def scan_glyphs():
+    """Collect all chars of the string and char literals within UI_SOURCES (except includes, static_assert() and Serial output)"""
+    glyphs = set()
+    for src in UI_SOURCES:
+        with open(os.path.join(PROJECT_DIR, src), encoding="utf-8") as f:
+            toks = list(tokens(f.read()))
+        i = 0
+        while i < len(toks):
+            kind, value = toks[i]
+            if kind == "id" and value in NON_UI_CALLS:
+                i = skip_call(toks, i)
+                continue
+            if kind == "id" and value == "include" and i and toks[i - 1][1] == "#":
+                i += 2  # Skip the "header.h" (<header.h> are no literals)
+                continue
+            if kind in ("str", "chr"):
+                glyphs.update(re.sub(r"\\.", "", value[1:-1]))  # Without escapes like \n or \0
+            i += 1
+    return glyphs
+
+
+def glyph_map(glyphs):
+    """Build a compact bdfconv -m map like "32,46,48-57" """
+    codes = sorted(ord(g) for g in glyphs if ord(g) >= 32)
+    ranges = []
+    for c in codes:
+        if ranges and c == ranges[-1][1] + 1:
+            ranges[-1][1] = c
+        else:
+            ranges.append([c, c])
+    return ",".join(str(a) if a == b else "%d-%d" % (a, b) for a, b in ranges)
+
+
+def bdfconv_cmd(bdfconv, font, m):
+    return [bdfconv, "-v"] + font["options"] + ["-m", m, font["bdf"], "-n", font["name"], "-o", font["name"] + ".hpp"]
+
+
+def logged_map(font):
+    """-m map of the last conversion, as logged within the conversion log"""
+    try:
+        with open(os.path.join(font_dir(), font["log"]), encoding="utf-8") as f:
+            found = re.search(r'-m "?([^"\s]*)', f.read())
+            return found.group(1) if found else None
+    except OSError:
+        return None
+
+
+def subset_fonts(check_only=False):
+    """Return the number of out-of-sync fonts, after a possible regeneration"""
+    bdfconv = os.environ.get("BDFCONV") or shutil.which("bdfconv")
+    scanned = scan_glyphs()
+    out_of_sync = 0
+
+    for font in FONTS:
+        glyphs = set(font["glyphs"]) | (scanned if font["scan"] else set())
+        m = glyph_map(glyphs)
+        if logged_map(font) == m:
+            continue
+
+        if check_only or not bdfconv:
+            print("Font %s is out of sync with the UI strings, required glyphs: %s" % (font["name"], m))
+            out_of_sync += 1
+            continue
+
+        cmd = bdfconv_cmd(bdfconv, font, m)
+        print("Regenerate font %s (glyphs: %s)" % (font["name"], m))
+        subprocess.check_call(cmd, cwd=font_dir())
+        with open(os.path.join(font_dir(), font["log"]), "w", encoding="utf-8") as f:
+            f.write("#\n%s\n" % " ".join('"%s"' % a if a == m else a for a in ["bdfconv"] + cmd[1:]))
+
+    if out_of_sync and not check_only:
+        print("Install bdfconv (or set BDFCONV) to regenerate the fonts")
+    return out_of_sync
+
+
+if __name__ == "__main__":
+    sys.exit(1 if subset_fonts("--check" in sys.argv) else 0)
+else:
+    Import("env")  # noqa: F821 (PlatformIO SCons)
+    PROJECT_DIR = env.subst("$PROJECT_DIR")  # noqa: F821
+    subset_fonts()
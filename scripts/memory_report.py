@@ -0,0 +1,79 @@
+#
+# PlatformIO extra script: Per object file RAM (.data/.bss) and flash (.text) usage report.
+#
+# Hooked in via "extra_scripts = post:scripts/memory_report.py" and printed after each
+# successful link, for every env. Helps to see where RAM goes before adding buffers or features.
+# Ends with the linked totals, formatted as a row of the "Usage" table within src/main.cpp.
+#
+import os
+import subprocess
+
+Import("env")
+
+
+def section_sizes(size_tool, obj):
+    """Return dict of section name -> size (bytes) as reported by "avr-size -A" """
+    sizes = {}
+    try:
+        out = subprocess.check_output([size_tool, "-A", obj], universal_newlines=True)
+    except (OSError, subprocess.CalledProcessError):
+        return sizes
+    for line in out.splitlines():
+        cols = line.split()
+        if len(cols) >= 2 and cols[0].startswith(".") and cols[1].isdigit():
+            name = cols[0]
+            # -ffunction-sections/-fdata-sections produce .bss.foo, .data.bar, .text.baz, ...
+            for base in (".data", ".bss", ".noinit", ".text", ".rodata"):
+                if name == base or name.startswith(base + "."):
+                    sizes[base] = sizes.get(base, 0) + int(cols[1])
+    return sizes
+
+
+def memory_report(source, target, env):
+    build_dir = env.subst("$BUILD_DIR")
+    size_tool = env.subst("$SIZETOOL") or "avr-size"
+
+    rows = []
+    for root, _, files in os.walk(build_dir):
+        for f in files:
+            if not f.endswith(".o"):
+                continue
+            obj = os.path.join(root, f)
+            s = section_sizes(size_tool, obj)
+            data = s.get(".data", 0)
+            bss = s.get(".bss", 0)
+            text = s.get(".text", 0) + s.get(".rodata", 0)
+            if data or bss or text:
+                rows.append((os.path.relpath(obj, build_dir), data, bss, text))
+
+    rows.sort(key=lambda r: (r[1] + r[2], r[3]), reverse=True)
+
+    print()
+    print("RAM/Flash usage per object file (%s)" % env.subst("$PIOENV"))
+    print("%-60s %6s %6s %6s %7s" % ("Object", ".data", ".bss", "RAM", "Flash"))
+    print("-" * 89)
+    tot_data = tot_bss = tot_text = 0
+    for obj, data, bss, text in rows:
+        print("%-60s %6d %6d %6d %7d" % (obj[-60:], data, bss, data + bss, text + data))
+        tot_data += data
+        tot_bss += bss
+        tot_text += text
+    print("-" * 89)
+    print("%-60s %6d %6d %6d %7d" % ("Total (before link-time garbage collection)",
+                                     tot_data, tot_bss, tot_data + tot_bss, tot_text + tot_data))
+
+    # Linked totals, like PlatformIO's "RAM:"/"Flash:" lines
+    s = section_sizes(size_tool, target[0].get_abspath())
+    ram = s.get(".data", 0) + s.get(".bss", 0) + s.get(".noinit", 0)
+    flash = s.get(".text", 0) + s.get(".data", 0)
+    board = env.BoardConfig()
+    max_ram = int(board.get("upload.maximum_ram_size", 2048))
+    max_flash = int(board.get("upload.maximum_size", 32256))
+    print()
+    print("src/main.cpp usage row (.data %d + .bss %d):" % (s.get(".data", 0), s.get(".bss", 0)))
+    print(" * %4.1f%%  %4d    %4.1f%% %5d   %s" % (100.0 * ram / max_ram, ram, 100.0 * flash / max_flash, flash,
+                                               env.subst("$PIOENV")))
+    print()
+
+
+env.AddPostAction("$BUILD_DIR/${PROGNAME}.elf", memory_report)
@@ -0,0 +1,82 @@
+#!/usr/bin/env python3
+#
+# Decode a binary control trace dump (serial command "T", see include/ControlTrace.hpp) into CSV.
+#
+# Usage:
+#   python3 scripts/trace_decode.py <dump.bin>
+#   python3 scripts/trace_decode.py --port /dev/ttyUSB0   (requires pyserial, sends "T" and reads the dump)
+#
+import argparse
+import struct
+import sys
+import zlib
+
+MAGIC = b"HPTR"
+HEADER = struct.Struct("<4sBBHHIB")
+FREEZE_REASONS = ["None", "Button", "Command", "SensorFault", "OverTemp"]
+STATES = {
+    1: ["StandBy", "Start", "Wait", "Heat", "Settle", "BangOn", "BangOff", "PID"],
+    2: ["Off", "PID", "BangOn", "BangOff", "TunerWait", "TunerHeat", "TunerSettle", "Fault"],
+}
+
+
+def read_port(port, baud):
+    import serial  # pyserial
+
+    with serial.Serial(port, baud, timeout=3) as ser:
+        ser.reset_input_buffer()
+        ser.write(b"T")
+        data = ser.read_until(MAGIC)
+        if not data.endswith(MAGIC):
+            sys.exit("No trace dump received")
+        data = MAGIC + ser.read(HEADER.size - len(MAGIC))
+        count, sample_size = struct.unpack_from("<H", data, 6)[0], data[5]
+        return data + ser.read(count * sample_size + 4)
+
+
+def decode(data):
+    magic, version, sample_size, count, interval_ms, tick_ms, reason = HEADER.unpack_from(data)
+    if magic != MAGIC or version not in STATES or sample_size != 3:
+        sys.exit("Unsupported dump (magic %r, version %d, sample size %d)" % (magic, version, sample_size))
+
+    end = HEADER.size + count * sample_size
+    if len(data) < end + 4:
+        sys.exit("Truncated dump")
+    crc = struct.unpack_from("<I", data, end)[0]
+    if zlib.crc32(data[:end]) & 0xFFFFFFFF != crc:
+        sys.exit("CRC mismatch")
+
+    print("# Freeze reason: %s, newest tick: %d ms" % (FREEZE_REASONS[reason] if reason < len(FREEZE_REASONS) else reason, tick_ms))
+    print("Tick(ms), Input(C), Setpoint(C), Duty(%), State")
+    for i in range(count):
+        b0, b1, b2 = data[HEADER.size + i * 3:HEADER.size + i * 3 + 3]
+        temp = b0 | ((b1 & 0x01) << 8)
+        duty = (b1 >> 1) & 0x0F
+        state = b1 >> 5
+        tick = tick_ms - (count - 1 - i) * interval_ms
+        print("%d, %s, %d, %d, %s" % (tick, "fault" if temp == 511 else temp, b2, round(duty * 100 / 15), STATES[version][state]))
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Decode a binary control trace dump")
+    parser.add_argument("file", nargs="?", help="Binary dump file")
+    parser.add_argument("--port", help="Serial port to read the dump from")
+    parser.add_argument("--baud", type=int, default=115200)
+    args = parser.parse_args()
+
+    if args.port:
+        data = read_port(args.port, args.baud)
+    elif args.file:
+        with open(args.file, "rb") as f:
+            data = f.read()
+        start = data.find(MAGIC)
+        if start < 0:
+            sys.exit("No trace dump found")
+        data = data[start:]
+    else:
+        parser.error("Either a dump file or --port is required")
+    decode(data)
+
+
+if __name__ == "__main__":
+    main()
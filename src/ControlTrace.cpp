@@ -0,0 +1,99 @@
+/*
+ * This file is part of the Another-HotPlate-Firmware project (https://github.com/Apehaenger/Another-HotPlate-Firmware).
+ * Copyright (c) 2022 Jörg Ebeling
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <Arduino.h>
+#include "CRC32.h"
+#include "main.hpp"
+#include "config.hpp"
+#include "ControlTrace.hpp"
+
+void ControlTrace::record(uint32_t tick_ms, double input, double setpoint, double output, uint8_t state)
+{
+    if (isFrozen())
+    {
+        return;
+    }
+
+    uint16_t in_c = isnan(input) ? 511 : constrain((int16_t)(input + 0.5), 0, 510);
+    uint8_t duty = constrain(output, 0, Config::active.pid_pwm_window_ms) * 15 / Config::active.pid_pwm_window_ms;
+    uint8_t *s = _samples[_head];
+
+    s[0] = in_c & 0xFF;
+    s[1] = (in_c >> 8) | (duty << 1) | ((state & 0x07) << 5);
+    s[2] = constrain((int16_t)setpoint, 0, 255);
+
+    _head = (_head + 1) % TRACE_SAMPLES;
+    if (_count < TRACE_SAMPLES)
+    {
+        _count++;
+    }
+    _lastTick_ms = tick_ms;
+
+    if (in_c == 511)
+    {
+        freeze(Freeze::SensorFault);
+    }
+    else if (in_c > Config::active.max_temp_c + HOTPLATE_OVERTEMP_MARGIN_C)
+    {
+        freeze(Freeze::OverTemp);
+    }
+}
+
+void ControlTrace::freeze(Freeze reason)
+{
+    if (!isFrozen())
+    {
+        _freeze = reason;
+    }
+}
+
+/**
+ * @brief Binary dump via serial and re-arm the trace afterwards
+ */
+void ControlTrace::dump()
+{
+    CRC32 crc;
+    uint8_t header[15] = {TRACE_MAGIC[0], TRACE_MAGIC[1], TRACE_MAGIC[2], TRACE_MAGIC[3],
+                          TRACE_FORMAT_VERSION, TRACE_SAMPLE_SIZE,
+                          (uint8_t)_count, (uint8_t)(_count >> 8),
+                          (uint8_t)PID_SAMPLE_MS, (uint8_t)(PID_SAMPLE_MS >> 8),
+                          (uint8_t)_lastTick_ms, (uint8_t)(_lastTick_ms >> 8), (uint8_t)(_lastTick_ms >> 16), (uint8_t)(_lastTick_ms >> 24),
+                          static_cast<uint8_t>(_freeze)};
+    Freeze reason = _freeze;
+
+    _freeze = Freeze::Command; // Don't record while dumping
+    if (reason == Freeze::None)
+    {
+        header[14] = static_cast<uint8_t>(Freeze::Command);
+    }
+
+    Serial.write(header, sizeof(header));
+    crc.update(header, sizeof(header));
+
+    for (uint8_t i = 0; i < _count; i++)
+    {
+        const uint8_t *s = _samples[(_head + TRACE_SAMPLES - _count + i) % TRACE_SAMPLES];
+        Serial.write(s, TRACE_SAMPLE_SIZE);
+        crc.update(s, TRACE_SAMPLE_SIZE);
+    }
+
+    uint32_t sum = crc.finalize();
+    Serial.write((const uint8_t *)&sum, sizeof(sum)); // AVR is little endian
+    Serial.flush();
+
+    _count = 0;
+    _freeze = Freeze::None;
+}
@@ -0,0 +1,129 @@
+/*
+ * This file is part of the Another-HotPlate-Firmware project (https://github.com/Apehaenger/Another-HotPlate-Firmware).
+ * Copyright (c) 2022 Jörg Ebeling
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <Arduino.h>
+#include "Graph.hpp"
+
+void Graph::start()
+{
+    _samples = 0;
+    _columns = 0;
+    _shift = 0;
+    _vertices = 0;
+    _revision++;
+}
+
+/**
+ * @brief Append a sample, once per PROFILE_STEP_MS
+ *
+ * @param temp_dc Plate temperature (1/10 °C)
+ * @param setpoint_dc Profile curve (1/10 °C)
+ */
+void Graph::record(int16_t temp_dc, int16_t setpoint_dc)
+{
+    if (_samples == UINT16_MAX) // ~18h @ 1s, column index would overflow
+    {
+        return;
+    }
+    if ((_samples >> _shift) >= GRAPH_COLUMNS)
+    {
+        decimate();
+    }
+
+    uint8_t x = _samples >> _shift;
+    uint8_t temp_c = constrain((temp_dc + 5) / 10, 0, 255);
+    uint16_t deviation_dc = abs(temp_dc - setpoint_dc);
+
+    if (!(_samples & ((1 << _shift) - 1)) || deviation_dc > _columnDeviation_dc) // First sample of the column, or larger deviation
+    {
+        _temp_c[x] = temp_c;
+        _columnDeviation_dc = deviation_dc;
+        _columns = x + 1;
+    }
+    recordCurve(setpoint_dc);
+    _samples++;
+    _revision++;
+}
+
+/**
+ * @brief Halve the columns. Of each column pair, the one with the larger deviation from the curve gets kept
+ */
+void Graph::decimate()
+{
+    for (uint8_t x = 0; x < GRAPH_COLUMNS / 2; x++)
+    {
+        uint8_t a = _temp_c[2 * x], b = _temp_c[2 * x + 1];
+        int16_t curveA_c = (curveAt((2 * x) << _shift) + 5) / 10;
+        int16_t curveB_c = (curveAt((2 * x + 1) << _shift) + 5) / 10;
+
+        _temp_c[x] = abs(a - curveA_c) >= abs(b - curveB_c) ? a : b;
+    }
+    _shift++;
+    _columns = GRAPH_COLUMNS / 2;
+}
+
+/**
+ * @brief Extend the curve polyline. The last vertex is the previous sample: If the new one continues its segment
+ * (same slope), the last vertex moves, otherwise the new sample becomes a vertex. Once all vertices are used up,
+ * the last one moves anyway (the curve gets coarser, but stays bounded)
+ */
+void Graph::recordCurve(int16_t setpoint_dc)
+{
+    Vertex v = {_samples, setpoint_dc};
+
+    if (_vertices >= 2)
+    {
+        Vertex &a = _curve[_vertices - 2], &b = _curve[_vertices - 1];
+
+        if ((int32_t)(b.temp_dc - a.temp_dc) == (int32_t)(setpoint_dc - b.temp_dc) * (b.sample - a.sample) ||
+            _vertices == GRAPH_VERTICES)
+        {
+            b = v;
+            return;
+        }
+    }
+    _curve[_vertices++] = v;
+}
+
+/**
+ * @brief Profile curve at sample (interpolated between the vertices)
+ *
+ * @return int16_t Setpoint (1/10 °C)
+ */
+int16_t Graph::curveAt(uint16_t sample)
+{
+    if (!_vertices)
+    {
+        return 0;
+    }
+
+    uint8_t i = 1;
+    while (i < _vertices && _curve[i].sample < sample)
+    {
+        i++;
+    }
+    if (i == _vertices)
+    {
+        return _curve[_vertices - 1].temp_dc;
+    }
+
+    const Vertex &a = _curve[i - 1], &b = _curve[i];
+    if (sample <= a.sample)
+    {
+        return a.temp_dc;
+    }
+    return a.temp_dc + (int32_t)(b.temp_dc - a.temp_dc) * (sample - a.sample) / (b.sample - a.sample);
+}
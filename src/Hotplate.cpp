@@ -17,49 +17,193 @@
 #include <Arduino.h>
 #include "main.hpp"
 #include "config.hpp"
+#include "FastGpio.hpp"
 
-Hotplate::Hotplate(uint8_t ssr_pin) : _ssrPin(ssr_pin),
-                                      _myPID(&_input, &_setpoint, &_output,
-                                             0, Config::active.pid_pwm_window_ms,
-                                             Config::active.pid_Kp, Config::active.pid_Ki, Config::active.pid_Kd)
+static_assert(PID_SAMPLE_MS >= TC_MAX_READ_INTERVAL_MS, "PID_SAMPLE_MS is shorter than the thermocouple conversion time");
+
+#if HOTPLATE_CHANNELS > 1
+uint32_t Hotplate::_lastSwitchOn_ms = 0;
+#endif
+
+Hotplate::Hotplate(uint8_t channel, int8_t profile_offset_c) : _channel(channel), _profileOffset_c(profile_offset_c),
+                                                               _myPID(&_input, &_setpoint, &_output,
+                                                                      0, Config::active.pid_pwm_window_ms,
+                                                                      Config::active.pid_Kp, Config::active.pid_Ki, Config::active.pid_Kd)
 {
+    _nextInterval_ms = (uint32_t)channel * PID_SAMPLE_MS / HOTPLATE_CHANNELS; // Staggered control ticks
 }
 
 void Hotplate::setup()
 {
-    pinMode(_ssrPin, OUTPUT);
-    setPower(false); // Be sure it's off
+    setPower(false); // Be sure it's off, before it becomes an output
+#if HOTPLATE_CHANNELS > 1
+    if (_channel)
+    {
+        FastPin<SSR2_PIN>::output();
+    }
+    else
+#endif
+    {
+        FastPin<SSR_Pin>::output();
+    }
+    thermocouples[_channel].begin();
 
     _myPID.setBangBang(Config::active.pid_bangOn_temp_c, Config::active.pid_bangOff_temp_c);
     _myPID.setTimeStep(PID_SAMPLE_MS); // time interval at which PID calculations are allowed to run in milliseconds
 }
 
+/**
+ * @brief Switch the SSR. On-time and switch-on's get accounted on level changes only (energy metering, relay wear)
+ */
 void Hotplate::setPower(bool pow)
 {
-    digitalWrite(_ssrPin, (pow ^ Config::active.ssr_active_low) ? HIGH : LOW);
+    bool level = pow ^ Config::active.ssr_active_low;
+
+    if (pow != _power)
+    {
+        uint32_t now = millis();
+        if (pow)
+        {
+            _powerOn_ms = now;
+            _switches++;
+        }
+        else
+        {
+            _onTime_ms += now - _powerOn_ms;
+        }
+    }
+#if HOTPLATE_CHANNELS > 1
+    if (_channel)
+    {
+        FastPin<SSR2_PIN>::write(level);
+    }
+    else
+#endif
+    {
+        FastPin<SSR_Pin>::write(level);
+    }
     _power = pow;
 }
 
-void Hotplate::setSetpoint(uint16_t setpoint)
+/*
+ * State machine tables. The rows are ordered initializers, each tagged with its state. The tag only feeds the
+ * static_assert of CHECK_ROWS(), which fails the build if a table misses a state or isn't in State order.
+ */
+#define TO(state) Hotplate::State::state
+#define ROW(state, ...) {__VA_ARGS__},
+#define ROW_STATE(state, ...) TO(state),
+#define CHECK_ROWS(rows)                                                                                              \
+    static constexpr Hotplate::State rows##_order[] = {rows(ROW_STATE)};                                              \
+    static_assert(sizeof(rows##_order) == static_cast<uint8_t>(Hotplate::State::Count) && inStateOrder(rows##_order), \
+                  #rows ": Not one row per state, in State order")
+
+template <size_t N>
+static constexpr bool inStateOrder(const Hotplate::State (&order)[N], size_t i = 0)
 {
-    _setpoint = setpoint;
+    return i == N || (static_cast<size_t>(order[i]) == i && inStateOrder(order, i + 1));
+}
+
+#define STATE_HANDLERS(ROW)                                                            \
+    ROW(StandBy, &Hotplate::enterStandBy, nullptr, nullptr)                            \
+    ROW(Manual, &Hotplate::enterPid, &Hotplate::tickPid, &Hotplate::exitPid)           \
+    ROW(Profile, &Hotplate::enterPid, &Hotplate::tickPid, &Hotplate::exitPid)          \
+    ROW(TunerArmed, nullptr, nullptr, nullptr)                                         \
+    ROW(TunerStart, nullptr, &Hotplate::tickTunerStart, nullptr)                       \
+    ROW(TunerWait, &Hotplate::enterTunerWait, &Hotplate::tickTunerWait, nullptr)       \
+    ROW(TunerHeat, nullptr, &Hotplate::tickTunerHeat, nullptr)                         \
+    ROW(TunerSettle, &Hotplate::enterTunerSettle, &Hotplate::tickTunerSettle, nullptr) \
+    ROW(Fault, &Hotplate::enterFault, nullptr, nullptr)
+CHECK_ROWS(STATE_HANDLERS);
 
-    if (!_setpoint)
+const Hotplate::StateHandlers Hotplate::_stateHandlers[] PROGMEM = {STATE_HANDLERS(ROW)};
+
+#define STATE_INFO(ROW)                                                      \
+    ROW(StandBy, 0, 0, "", "")                                               \
+    ROW(Manual, STATE_HEATING, 0, "", "")                                    \
+    ROW(Profile, STATE_HEATING, 0, "", "")                                   \
+    ROW(TunerArmed, STATE_TUNER, 0, "PID Tuner", "Push to start")            \
+    ROW(TunerStart, STATE_TUNER, 4, "PID Tuner", "")                         \
+    ROW(TunerWait, STATE_TUNER | STATE_HEATING, 4, "Tuner: Wait...", "")     \
+    ROW(TunerHeat, STATE_TUNER | STATE_HEATING, 5, "Tuner: Heat...", "")     \
+    ROW(TunerSettle, STATE_TUNER | STATE_HEATING, 6, "Tuner: Settle...", "") \
+    ROW(Fault, 0, 7, "Heater FAULT", "Push to reset")
+CHECK_ROWS(STATE_INFO);
+
+const Hotplate::StateInfo Hotplate::_stateInfo[] PROGMEM = {STATE_INFO(ROW)};
+
+// Next state by current state (row) and event (column). Same state = event gets ignored
+// Columns: Stop, Setpoint, Off, Profile, ProfileEnd, Tune, Start, Next, Done, Fault
+#define TRANSITIONS(ROW)                                                                                                                                                      \
+    ROW(StandBy, TO(StandBy), TO(Manual), TO(StandBy), TO(Profile), TO(StandBy), TO(TunerArmed), TO(StandBy), TO(StandBy), TO(StandBy), TO(StandBy))                          \
+    ROW(Manual, TO(StandBy), TO(Manual), TO(StandBy), TO(Profile), TO(Manual), TO(TunerArmed), TO(Manual), TO(Manual), TO(Manual), TO(Fault))                                 \
+    ROW(Profile, TO(StandBy), TO(Profile), TO(StandBy), TO(Profile), TO(StandBy), TO(Profile), TO(Profile), TO(Profile), TO(Profile), TO(Fault))                              \
+    ROW(TunerArmed, TO(StandBy), TO(TunerArmed), TO(StandBy), TO(TunerArmed), TO(TunerArmed), TO(TunerArmed), TO(TunerStart), TO(TunerArmed), TO(TunerArmed), TO(TunerArmed)) \
+    ROW(TunerStart, TO(StandBy), TO(TunerStart), TO(StandBy), TO(TunerStart), TO(TunerStart), TO(TunerStart), TO(TunerStart), TO(TunerWait), TO(TunerStart), TO(Fault))       \
+    ROW(TunerWait, TO(StandBy), TO(TunerWait), TO(StandBy), TO(TunerWait), TO(TunerWait), TO(TunerWait), TO(TunerWait), TO(TunerHeat), TO(TunerWait), TO(Fault))              \
+    ROW(TunerHeat, TO(StandBy), TO(TunerHeat), TO(StandBy), TO(TunerHeat), TO(TunerHeat), TO(TunerHeat), TO(TunerHeat), TO(TunerSettle), TO(TunerHeat), TO(Fault))            \
+    ROW(TunerSettle, TO(StandBy), TO(TunerSettle), TO(StandBy), TO(TunerSettle), TO(TunerSettle), TO(TunerSettle), TO(TunerSettle), TO(TunerWait), TO(StandBy), TO(Fault))    \
+    ROW(Fault, TO(StandBy), TO(Fault), TO(Fault), TO(Fault), TO(Fault), TO(Fault), TO(Fault), TO(Fault), TO(Fault), TO(Fault))
+CHECK_ROWS(TRANSITIONS);
+
+const Hotplate::State Hotplate::_transitions[][static_cast<uint8_t>(Event::Count)] PROGMEM = {TRANSITIONS(ROW)};
+
+#undef CHECK_ROWS
+#undef ROW_STATE
+#undef ROW
+#undef TO
+#undef TRANSITIONS
+#undef STATE_INFO
+#undef STATE_HANDLERS
+
+/**
+ * @brief Handle an event: Look up the next state and run the exit handler of the current and the entry handler of the next state
+ *
+ * @return true if the state changed
+ * @return false if the event got ignored within the current state
+ */
+bool Hotplate::dispatch(Event ev)
+{
+    State next;
+    StateHandlers h;
+
+    memcpy_P(&next, &_transitions[static_cast<uint8_t>(_state)][static_cast<uint8_t>(ev)], sizeof(next));
+    if (next == _state)
     {
-        _mode = Mode::Manual;
-        _state = State::StandBy;
-        _myPID.stop();
-        _output = 0;
-        setPower(false); // Don't wait for the next loop()
-        return;
+        return false;
     }
 
-    if (_state == State::StandBy)
+    uint32_t now = millis();
+    memcpy_P(&h, &_stateHandlers[static_cast<uint8_t>(_state)], sizeof(h));
+    if (h.exit)
+        (this->*h.exit)(now);
+    _state = next;
+    memcpy_P(&h, &_stateHandlers[static_cast<uint8_t>(_state)], sizeof(h));
+    if (h.entry)
+        (this->*h.entry)(now);
+    return true;
+}
+
+/**
+ * @brief Latch a new setpoint, which gets followed by the next control tick (see tickPid()).
+ * Called from loop() (knob inputs get queued by the encoder ISR and handled by handleKnobInputs()), and the SSR
+ * window phase keeps undisturbed by continuous knob turns. Setpoint 0 (off) gets latched as well.
+ */
+void Hotplate::setSetpoint(uint16_t setpoint)
+{
+    _target = setpoint;
+    _targetOff = !setpoint;
+}
+
+/**
+ * @brief Set the setpoint of a profile bound channel, with the channels profile offset applied
+ */
+void Hotplate::setProfileSetpoint(uint16_t setpoint)
+{
+    if (!isProfileBound())
     {
-        _state = State::PID;
+        return;
     }
-    _myPID.run();
-    _pwmWindowStart_ms = millis();
+    setSetpoint(constrain((int16_t)setpoint + _profileOffset_c, 1, Config::active.max_temp_c));
 }
 
 /**
@@ -75,13 +219,168 @@ bool Hotplate::pwmWindowReached()
     return (millis() - _pwmWindowStart_ms > Config::active.pid_pwm_window_ms);
 }
 
+/**
+ * @brief Start of a new SSR window. If another channel is already heating, the window gets aligned
+ * to the other channels window, shifted by the channel phase (window / HOTPLATE_CHANNELS),
+ * so that SSR switch-on's of different channels never coincide.
+ *
+ * @return Start time (<= now) of the (phase aligned) window
+ */
+uint32_t Hotplate::getWindowStart(uint32_t now)
+{
+#if HOTPLATE_CHANNELS > 1
+    uint16_t window = Config::active.pid_pwm_window_ms;
+
+    for (uint8_t i = 0; i < HOTPLATE_CHANNELS; i++)
+    {
+        Hotplate &other = hotplates[i];
+        if (&other == this || !other.isHeating())
+        {
+            continue;
+        }
+        uint32_t phase_ms = (uint32_t)((_channel + HOTPLATE_CHANNELS - other._channel) % HOTPLATE_CHANNELS) * window / HOTPLATE_CHANNELS;
+        return now - (now - other._pwmWindowStart_ms + window - phase_ms) % window;
+    }
+#endif
+    return now;
+}
+
 void serialPrintLine()
 {
-    Serial.println("-------------------");
+    Serial.println(F("-------------------"));
+}
+
+// ----- State handlers -----
+
+void Hotplate::enterStandBy(uint32_t)
+{
+    _target = 0;
+    _setpoint = 0;
+    _output = 0;
+    setPower(false); // Don't wait for the next loop()
+}
+
+/**
+ * @brief Manual and Profile: Start the PID with a new (phase aligned) SSR window
+ */
+void Hotplate::enterPid(uint32_t now)
+{
+    _pwmWindowStart_ms = getWindowStart(now);
+    _setpoint = Config::active.setpoint_slew_cs ? _input : _target;
+}
+
+void Hotplate::exitPid(uint32_t)
+{
+    _myPID.stop();
+    _control = Control::Off;
+}
+
+/**
+ * @brief Let the PID setpoint follow the commanded one, limited to Config::setpoint_slew_cs, and run the PID
+ */
+void Hotplate::tickPid(uint32_t)
+{
+    uint16_t target;
+
+    noInterrupts(); // Might get set by the encoder ISR
+    target = _target;
+    interrupts();
+
+    double step = Config::active.setpoint_slew_cs * PID_SAMPLE_MS / 1000.0;
+    if (!step || fabs(target - _setpoint) <= step)
+        _setpoint = target;
+    else
+        _setpoint += target > _setpoint ? step : -step;
+
+    _myPID.run();
+    // Informative controller output. Logic copied from AutoPID.cpp
+    if (Config::active.pid_bangOn_temp_c && ((_setpoint - _input) > Config::active.pid_bangOn_temp_c))
+        _control = Control::BangOn;
+    else if (Config::active.pid_bangOff_temp_c && ((_input - _setpoint) > Config::active.pid_bangOff_temp_c))
+        _control = Control::BangOff;
+    else
+        _control = Control::PID;
+}
+
+void Hotplate::tickTunerStart(uint32_t)
+{
+    Serial.println(F("Copy & Paste to https://pidtuner.com"));
+    Serial.println(F("Time, Input, Output"));
+    serialPrintLine();
+    dispatch(Event::Next);
+}
+
+/**
+ * @brief Wait one pwmWindow before start. PID Tuner calculations may fail if not started with 0 output
+ */
+void Hotplate::enterTunerWait(uint32_t now)
+{
+    _output = 0;
+    _pwmWindowStart_ms = getWindowStart(now);
+}
+
+void Hotplate::tickTunerWait(uint32_t)
+{
+    if (!pwmWindowReached())
+    {
+        return;
+    }
+    _pidTunerTempTarget = _input + PID_TUNER_TEMP_STEPS_C;
+    _target = _setpoint = _pidTunerTempTarget;
+    _output = Config::active.pid_pwm_window_ms;
+    dispatch(Event::Next);
+}
+
+void Hotplate::tickTunerHeat(uint32_t)
+{
+    _setpoint = _target; // The user may adapt the target during heatup
+    if (_input > _setpoint)
+    {
+        dispatch(Event::Next);
+    }
+}
+
+void Hotplate::enterTunerSettle(uint32_t now)
+{
+    _target = _setpoint = 0;
+    _output = 0;
+    _pwmWindowStart_ms = getWindowStart(now);
+    _pidTunerTempMax = _input;
+}
+
+void Hotplate::tickTunerSettle(uint32_t)
+{
+    if (_input > _pidTunerTempMax) // overshooting
+    {
+        _pidTunerTempMax = _input;
+        return;
+    }
+    if (_input > (_pidTunerTempMax - PID_TUNER_TEMP_SETTLED_C)) // Not yet settled
+    {
+        return;
+    }
+    if (_input + PID_TUNER_TEMP_STEPS_C < Config::active.max_temp_c)
+    {
+        dispatch(Event::Next); // One more step
+        return;
+    }
+    serialPrintLine();
+    Serial.print(F("Done. Last step overshot (BangON) = "));
+    Serial.println(_pidTunerTempMax - _pidTunerTempTarget);
+    dispatch(Event::Done);
+}
+
+void Hotplate::enterFault(uint32_t)
+{
+    _output = 0;
+    setPower(false);
+    Serial.print(F("Heater fault, channel "));
+    Serial.println(_channel);
 }
 
 void Hotplate::loop()
 {
+    StateHandlers h;
     uint32_t now = millis();
     if (now < _nextInterval_ms)
     {
@@ -89,103 +388,80 @@ void Hotplate::loop()
     }
     _nextInterval_ms = now + PID_SAMPLE_MS;
 
-    _input = thermocouple.getTemperatureAverage();
+    _input = thermocouples[_channel].getTemperatureAverage();
+    if (isnan(_input) || _input > Config::active.max_temp_c + HOTPLATE_OVERTEMP_MARGIN_C)
+    {
+        dispatch(Event::Fault);
+    }
+    if (_targetOff)
+    {
+        _targetOff = false;
+        dispatch(Event::Off);
+    }
+    else if (_target)
+    {
+        dispatch(Event::Setpoint);
+    }
 
-    switch (_state)
+    memcpy_P(&h, &_stateHandlers[static_cast<uint8_t>(_state)], sizeof(h));
+    if (h.tick)
     {
-    case State::StandBy: // Wait for "Press start"
-        setPower(false);
-        return;
-    case State::PID:
-    case State::BangOn:
-    case State::BangOff:
-        _myPID.run();
-        // Informative state changes. Logic copied from AutoPID.cpp
-        if (Config::active.pid_bangOn_temp_c && ((_setpoint - _input) > Config::active.pid_bangOn_temp_c))
-            _state = State::BangOn;
-        else if (Config::active.pid_bangOff_temp_c && ((_input - _setpoint) > Config::active.pid_bangOff_temp_c))
-            _state = State::BangOff;
-        else
-            _state = State::PID;
-        break;
-    case State::Start: // Start/Init PID Tuner
-        Serial.println("Copy & Paste to https://pidtuner.com");
-        Serial.println("Time, Input, Output");
-        serialPrintLine();
-        _pwmWindowStart_ms = now;
-        _state = State::Wait;
-        break;
-    case State::Wait: // Wait one pwmWindow before start. PID Tuner calculations may fail if not started with 0 output
-        if (!pwmWindowReached())
-        {
-            break;
-        }
-        _pidTunerTempTarget = _input + PID_TUNER_TEMP_STEPS_C;
-        _setpoint = _pidTunerTempTarget;
-        _state = State::Heat;
-        _output = Config::active.pid_pwm_window_ms;
-        break;
-    case State::Heat:
-        if (_input > _setpoint) // By the use of _input the user may adapt the target during heatup
-        {
-            _setpoint = 0;
-            _output = 0;
-            _pwmWindowStart_ms = now;
-            _pidTunerTempMax = _input;
-            _state = State::Settle;
-        }
-        break;
-    case State::Settle:
-        if (_input > _pidTunerTempMax) // overshooting
-        {
-            _pidTunerTempMax = _input;
-            break;
+        (this->*h.tick)(now);
+    }
+
+    // Soft PWM
+    bool power = false;
+    if (isHeating())
+    {
+        if (pwmWindowReached())
+        { // time to shift the Relay Window
+            _pwmWindowStart_ms += Config::active.pid_pwm_window_ms;
         }
-        if (_input <= (_pidTunerTempMax - PID_TUNER_TEMP_SETTLED_C)) // Settled
+        power = _output > now - _pwmWindowStart_ms;
+#if HOTPLATE_CHANNELS > 1
+        if (power && !_power)
         {
-            if (_input + PID_TUNER_TEMP_STEPS_C < Config::active.max_temp_c)
+            if (now - _lastSwitchOn_ms < HOTPLATE_SWITCH_GAP_MS)
             {
-                // One more step
-                _state = State::Wait;
-                break;
+                power = false; // Another channel just switched on, retry with the next tick
+            }
+            else
+            {
+                _lastSwitchOn_ms = now;
             }
-            _state = State::StandBy;
-            _mode = Mode::Manual;
-            serialPrintLine();
-            Serial.print("Done. Last step overshot (BangON) = ");
-            Serial.println(_pidTunerTempMax - _pidTunerTempTarget);
         }
-        break;
+#endif
     }
-
-    // Soft PWM
-    if (pwmWindowReached())
-    { // time to shift the Relay Window
-        _pwmWindowStart_ms += Config::active.pid_pwm_window_ms;
+    setPower(power);
+#ifdef CONTROL_TRACE
+    if (!_channel) // Trace of the lead channel only
+    {
+        uint8_t trace = pgm_read_byte(&_stateInfo[static_cast<uint8_t>(_state)].trace);
+        controlTrace.record(now, _input, _setpoint, _output, trace ? trace : static_cast<uint8_t>(_control));
     }
-    setPower(_output > now - _pwmWindowStart_ms);
+#endif
 
 #ifdef DEBUG_SERIAL_OFF
-    Serial.print("Setpoint: ");
+    Serial.print(F("Setpoint: "));
     Serial.print(_setpoint);
-    Serial.print(", Input: ");
+    Serial.print(F(", Input: "));
     Serial.print(_input);
-    Serial.print(", Controller state: ");
-    Serial.print(_state);
-    Serial.print(", Output: ");
+    Serial.print(F(", Controller state: "));
+    Serial.print(static_cast<uint8_t>(_state));
+    Serial.print(F(", Output: "));
     Serial.print(_output);
-    Serial.print(", SSR: ");
+    Serial.print(F(", SSR: "));
     Serial.println(_power);
 #endif
 
-    if (isMode(Mode::PIDTuner) && !isState(State::StandBy) &&
+    if ((pgm_read_byte(&_stateInfo[static_cast<uint8_t>(_state)].flags) & (STATE_TUNER | STATE_HEATING)) == (STATE_TUNER | STATE_HEATING) &&
         now >= _pidTunerOutputNext_ms)
     {
         _pidTunerOutputNext_ms = now + PID_TUNER_INTERVAL_MS;
         Serial.print((float)now / 1000);
-        Serial.print(", ");
+        Serial.print(F(", "));
         Serial.print(_output);
-        Serial.print(", ");
+        Serial.print(F(", "));
         Serial.println(_input);
     }
 }
\ No newline at end of file
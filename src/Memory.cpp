@@ -0,0 +1,99 @@
+/*
+ * This file is part of the Another-HotPlate-Firmware project (https://github.com/Apehaenger/Another-HotPlate-Firmware).
+ * Copyright (c) 2022 Jörg Ebeling
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <Arduino.h>
+#include "Memory.hpp"
+
+// Linker/avr-libc symbols
+extern uint8_t __heap_start; // == _end if no .noinit section
+extern char *__brkval;       // Current heap top, or 0 if malloc() never got called
+
+namespace Memory
+{
+        uint8_t *_heapPeak = &__heap_start; // Highest heap top seen by update()
+
+        /**
+         * @brief Paint the free RAM with MEMORY_CANARY.
+         * Runs in .init3, i.e. after the stack pointer got set up (.init2) but before .data/.bss get initialized (.init4),
+         * so there's no C runtime yet and the function has to be naked without any call.
+         */
+        void paintStack() __attribute__((naked, used, section(".init3")));
+        void paintStack()
+        {
+                uint8_t *p = &__heap_start;
+                while (p < (uint8_t *)SP)
+                {
+                        *p++ = MEMORY_CANARY;
+                }
+        }
+
+        /**
+         * @brief Current heap top, which is __heap_start if malloc() never got called
+         */
+        uint8_t *heapTop()
+        {
+                return __brkval ? (uint8_t *)__brkval : &__heap_start;
+        }
+
+        void update()
+        {
+                uint8_t *top = heapTop();
+                if (top > _heapPeak)
+                {
+                        _heapPeak = top;
+                }
+        }
+
+        uint16_t getFreeRam()
+        {
+                return (uint8_t *)SP - heapTop();
+        }
+
+        uint16_t getUnusedRam()
+        {
+                update();
+                uint8_t *p = _heapPeak;
+                while (p <= (uint8_t *)RAMEND && *p == MEMORY_CANARY)
+                {
+                        p++;
+                }
+                return p - _heapPeak;
+        }
+
+        uint16_t getStackPeak()
+        {
+                uint16_t unused = getUnusedRam(); // Does update()
+                return (uint8_t *)RAMEND + 1 - (_heapPeak + unused);
+        }
+
+        uint16_t getHeapPeak()
+        {
+                update();
+                return _heapPeak - &__heap_start;
+        }
+
+        void printReport()
+        {
+                Serial.print(F("RAM free: "));
+                Serial.print(getFreeRam());
+                Serial.print(F(", unused (low-water): "));
+                Serial.print(getUnusedRam());
+                Serial.print(F(", stack peak: "));
+                Serial.print(getStackPeak());
+                Serial.print(F(", heap peak: "));
+                Serial.println(getHeapPeak());
+        }
+}
@@ -18,28 +18,523 @@
 #include "main.hpp"
 #include "config.hpp"
 
+/*
+ * Compile time profile table builder (C++11 constexpr, thus recursion instead of loops).
+ *
+ * A profile is just its segment table. ProfileTable<> derives everything else from it: The length, the liquidus temp
+ * (threshold of the Dwell segment) and a plan per segment (setpoint step and reciprocal rate in fixed point, nominal
+ * duration of the following segments). So there's nothing to keep in sync by hand, and neither the segment
+ * interpreter nor the time left estimate needs a division at runtime. PROFILE_CHECKS() rejects broken tables
+ * at compile time, and a peak above its max. temp: The shipped default max_temp_c, or PROFILE_HIGH_TEMP_MAX_C for the
+ * high temp. pastes, which need max_temp_c raised in Setup (startProfile() refuses them until then).
+ */
+namespace
+{
+    typedef Profile::Segment Segment;
+    typedef Profile::SegmentType SegmentType;
+
+    constexpr bool isRate(const Segment &seg)
+    {
+        return seg.type == SegmentType::RampRate || seg.type == SegmentType::CoolRate;
+    }
+
+    constexpr uint8_t prevTemp(const Segment *segs, uint8_t i)
+    {
+        return i ? segs[i - 1].temp_c : PROFILE_AMBIENT_C;
+    }
+
+    // Nominal duration of segment i. Ramps start at the previous segment's temp, HoldTemp takes no time
+    constexpr uint16_t nominal_s(const Segment *segs, uint8_t i)
+    {
+        return isRate(segs[i]) ? 10 * (segs[i].temp_c > prevTemp(segs, i) ? segs[i].temp_c - prevTemp(segs, i)
+                                                                            : prevTemp(segs, i) - segs[i].temp_c) /
+                                     segs[i].arg
+                               : (segs[i].type == SegmentType::HoldTemp ? 0 : segs[i].time_s);
+    }
+
+    constexpr uint16_t after_s(const Segment *segs, uint8_t n, uint8_t i)
+    {
+        return i + 1 < n ? nominal_s(segs, i + 1) + after_s(segs, n, i + 1) : 0;
+    }
+
+    constexpr Profile::SegmentPlan plan(const Segment *segs, uint8_t n, uint8_t i)
+    {
+        return {static_cast<uint16_t>((uint32_t)segs[i].arg * PROFILE_STEP_MS / 1000),
+                static_cast<uint16_t>(isRate(segs[i]) ? (1UL << PROFILE_RATE_SHIFT) / segs[i].arg : 0),
+                after_s(segs, n, i)};
+    }
+
+    constexpr uint8_t liquidus(const Segment *segs, uint8_t n)
+    {
+        return !n ? 0 : (segs->type == SegmentType::Dwell ? segs->arg : liquidus(segs + 1, n - 1));
+    }
+
+    constexpr uint8_t peak(const Segment *segs, uint8_t n)
+    {
+        return !n ? 0 : (segs->temp_c > peak(segs + 1, n - 1) ? segs->temp_c : peak(segs + 1, n - 1));
+    }
+
+    // Table checks, per segment
+    constexpr bool hasRate(const Segment *segs, uint8_t i) { return !isRate(segs[i]) || segs[i].arg; }
+    constexpr bool hasTime(const Segment *segs, uint8_t i)
+    {
+        return (segs[i].type != SegmentType::HoldTime && segs[i].type != SegmentType::Dwell) || segs[i].time_s;
+    }
+    constexpr bool rampRises(const Segment *segs, uint8_t i)
+    {
+        return segs[i].type != SegmentType::RampRate || segs[i].temp_c > prevTemp(segs, i);
+    }
+    constexpr bool coolFalls(const Segment *segs, uint8_t i)
+    {
+        return segs[i].type != SegmentType::CoolRate || segs[i].temp_c < prevTemp(segs, i);
+    }
+    constexpr bool dwellBelowPeak(const Segment *segs, uint8_t i)
+    {
+        return segs[i].type != SegmentType::Dwell || segs[i].arg < segs[i].temp_c;
+    }
+
+    template <bool (*Check)(const Segment *, uint8_t)>
+    constexpr bool all(const Segment *segs, uint8_t n, uint8_t i = 0)
+    {
+        return i >= n || (Check(segs, i) && all<Check>(segs, n, i + 1));
+    }
+
+    template <uint8_t... I>
+    struct Indices
+    {
+    };
+    template <uint8_t N, uint8_t... I>
+    struct MakeIndices : MakeIndices<N - 1, N - 1, I...>
+    {
+    };
+    template <uint8_t... I>
+    struct MakeIndices<0, I...>
+    {
+        typedef Indices<I...> type;
+    };
+
+    template <uint8_t N, const Segment (&S)[N], typename = typename MakeIndices<N>::type>
+    struct ProfileTable;
+
+    template <uint8_t N, const Segment (&S)[N], uint8_t... I>
+    struct ProfileTable<N, S, Indices<I...>>
+    {
+        static const Profile::SegmentPlan plans[N];
+    };
+
+    template <uint8_t N, const Segment (&S)[N], uint8_t... I>
+    const Profile::SegmentPlan ProfileTable<N, S, Indices<I...>>::plans[N] PROGMEM = {plan(S, N, I)...};
+}
+
+#define PROFILE_LENGTH(segs) static_cast<uint8_t>(sizeof(segs) / sizeof(segs[0]))
+
+#define PROFILE_CHECKS(segs, maxTemp_c)                                                                            \
+    static_assert(PROFILE_LENGTH(segs) <= PROFILE_SEGMENTS_MAX, #segs ": More than PROFILE_SEGMENTS_MAX segments"); \
+    static_assert(peak(segs, PROFILE_LENGTH(segs)) <= (maxTemp_c), #segs ": Peak above its max. temperature");      \
+    static_assert(all<hasRate>(segs, PROFILE_LENGTH(segs)), #segs ": RampRate/CoolRate without rate");              \
+    static_assert(all<hasTime>(segs, PROFILE_LENGTH(segs)), #segs ": HoldTime/Dwell without time");                 \
+    static_assert(all<rampRises>(segs, PROFILE_LENGTH(segs)), #segs ": RampRate below the previous temperature");   \
+    static_assert(all<coolFalls>(segs, PROFILE_LENGTH(segs)), #segs ": CoolRate above the previous temperature");   \
+    static_assert(all<dwellBelowPeak>(segs, PROFILE_LENGTH(segs)), #segs ": Dwell threshold not below its temp");   \
+    static_assert(liquidus(segs, PROFILE_LENGTH(segs)), #segs ": No Dwell (time above liquidus) segment");          \
+    static_assert(segs[PROFILE_LENGTH(segs) - 1].type == SegmentType::CoolRate, #segs ": Doesn't end with CoolRate")
+
+#define PROFILE_TABLE(segs) \
+    {segs, ProfileTable<PROFILE_LENGTH(segs), segs>::plans, PROFILE_LENGTH(segs), liquidus(segs, PROFILE_LENGTH(segs)), \
+     peak(segs, PROFILE_LENGTH(segs))}
+
+/*
+ * Reflow profiles, according to the solder paste datasheets
+ */
+static constexpr Segment segments_Sn42Bi576Ag04[] PROGMEM = {
+    {SegmentType::RampRate, 120, 8, 0},   // Preheat @ 0.8 °C/s
+    {SegmentType::HoldTime, 120, 0, 60},  // Soak
+    {SegmentType::RampRate, 165, 10, 0},  // Reflow ramp @ 1.0 °C/s
+    {SegmentType::Dwell, 165, 138, 45},   // 45 s above liquidus (138 °C)
+    {SegmentType::CoolRate, 100, 30, 0},  // Cool down @ 3.0 °C/s
+};
+PROFILE_CHECKS(segments_Sn42Bi576Ag04, Config::Conf().max_temp_c); // Runs with the default config
+
+static constexpr Segment segments_Sn965Ag30Cu05[] PROGMEM = {
+    {SegmentType::RampRate, 150, 15, 0},  // Preheat @ 1.5 °C/s
+    {SegmentType::RampRate, 180, 3, 0},   // Soak, slow ramp @ 0.3 °C/s
+    {SegmentType::RampRate, 249, 15, 0},  // Reflow ramp @ 1.5 °C/s
+    {SegmentType::HoldTemp, 249, 0, 30},  // Wait for the plate to catch up the peak temp
+    {SegmentType::Dwell, 249, 217, 60},   // 60 s above liquidus (217 °C)
+    {SegmentType::CoolRate, 150, 30, 0},  // Cool down @ 3.0 °C/s
+};
+PROFILE_CHECKS(segments_Sn965Ag30Cu05, PROFILE_HIGH_TEMP_MAX_C);
+
+/*
+ * One row per Profiles entry, in Profiles order (checked below): Name and segment table
+ */
+#define PROFILES(ROW)                                                               \
+    ROW(Manual, "Manual", {nullptr, nullptr, 0, 0, 0})                              \
+    ROW(Sn42Bi576Ag04, "Sn42/Bi57.6/Ag0.4", PROFILE_TABLE(segments_Sn42Bi576Ag04)) \
+    ROW(Sn965Ag30Cu05, "Sn96.5/Ag3.0/Cu0.5", PROFILE_TABLE(segments_Sn965Ag30Cu05))
+#define ROW_ID(id, name, ...) Profile::id,
+#define ROW_NAME(id, name, ...) name,
+#define ROW_TABLE(id, name, ...) __VA_ARGS__,
+
+template <size_t N>
+static constexpr bool inProfilesOrder(const Profile::Profiles (&order)[N], size_t i = 0)
+{
+    return i == N || (static_cast<size_t>(order[i]) == i && inProfilesOrder(order, i + 1));
+}
+static constexpr Profile::Profiles profilesOrder[] = {PROFILES(ROW_ID)};
+static_assert(sizeof(profilesOrder) == sizeof(Profile::profileNames) / sizeof(Profile::profileNames[0]) &&
+                  inProfilesOrder(profilesOrder),
+              "PROFILES: Not one row per profile, in Profiles order");
+
+const char Profile::profileNames[][PROFILE_NAME_SIZE] PROGMEM = {PROFILES(ROW_NAME)};
+const Profile::ProfileSegments Profile::_profileSegments[] PROGMEM = {PROFILES(ROW_TABLE)};
+
+#undef ROW_TABLE
+#undef ROW_NAME
+#undef ROW_ID
+#undef PROFILES
+
+#undef PROFILE_CHECKS
+#undef PROFILE_TABLE
+#undef PROFILE_LENGTH
+
 /**
  * @brief Start profile if not already started
  *
  * @return true if profile got started
- * @return false if profile is already running
+ * @return false if profile is already running, or it can't run (see isAboveMaxTemp())
  */
 bool Profile::startProfile()
 {
-    if (_profileStart_ms) // Profile already running
+    if (_profileStart_ms || _batch == Batch::Cooling || // Profile already running, or plate not yet ready
+        hotplates[0].isState(Hotplate::State::Fault))
+    {
+        return false;
+    }
+    if (isAboveMaxTemp())
     {
+        Serial.print(F("Profile peak above max. temp: "));
+        Serial.println(pgm_read_byte(&_profileSegments[Config::active.profile].peak_c));
         return false;
     }
-    _profileStart_ms = millis();
-    _nextInterval_ms = 0;
-    hotplate.setState(Hotplate::State::PID);
+    if (_batch == Batch::Off)
+    {
+        _batchDone = 0;
+    }
+    _batch = Config::active.batch_runs > 1 ? Batch::Running : Batch::Off;
+    setFan(0);
+    _profileStart_ms = _segmentStart_ms = millis();
+    _nextStep_ms = 0;
+    _segment = 0;
+    _segmentSteps = 0; // The first step runs right away
+    _dwell_s = 0;
+    _finished = false;
+    dispatchBoundChannels(Hotplate::Event::Profile);
+
+    // Reset run metrics. The profile curve starts at the current plate temp
+    _startTemp_dc = _lastTemp_dc = _setpoint_dc = thermocouples[0].getTemperatureAverage() * 10;
+    _metrics = {};
+    _metrics.peak_dc = _startTemp_dc;
+    _metrics.profile = Config::active.profile;
+    memset(_metrics.segmentDuty, PROFILE_DUTY_SKIPPED, sizeof(_metrics.segmentDuty));
+    for (uint8_t i = 0; i < HOTPLATE_CHANNELS; i++)
+    {
+        _startOnTime_ms[i] = hotplates[i].getOnTime_ms();
+    }
+    _segmentOnTime_ms = _startOnTime_ms[0];
+    _startSwitches = hotplates[0].getSwitches();
+    _energyOnTime_ms = _energyRest = 0;
+#ifdef LIVE_GRAPH
+    graph.start();
+#endif
+
+    if (Config::active.profile_warm_start || _holdTemp_c)
+    {
+        seekSegment(_startTemp_dc, _holdTemp_c);
+    }
+    _holdTemp_c = 0;
     return true;
 }
 
-void Profile::stopProfile()
+/**
+ * @brief Stop profile (and abort a batch)
+ *
+ * @return true if a profile was running (and the run metrics got finalized)
+ * @return false if no profile was running
+ */
+bool Profile::stopProfile()
 {
+    bool wasRunning = _profileStart_ms;
+
     _profileStart_ms = 0;
-    hotplate.setState(Hotplate::State::StandBy);
+    _holdTemp_c = 0;
+    _batch = Batch::Off;
+    setFan(0);
+    dispatchBoundChannels(Hotplate::Event::ProfileEnd);
+    if (wasRunning)
+    {
+        updateSegmentDuty(millis()); // Aborted within a segment
+    }
+    _printMetrics |= wasRunning; // Printed by the next loop(), as this might get called from a time critical context
+    return wasRunning;
+}
+
+/**
+ * @brief Last segment is done: Heater(s) off and stop. Within a batch, cool down for the next run
+ * (the run summary only gets shown at the end of the batch)
+ */
+void Profile::finishProfile()
+{
+    bool batch = _batch != Batch::Off;
+
+    for (Hotplate &hotplate : hotplates)
+    {
+        if (hotplate.isProfileBound())
+        {
+            hotplate.setSetpoint(0);
+        }
+    }
+    stopProfile();
+    startHold();
+
+    if (batch && ++_batchDone < Config::active.batch_runs)
+    {
+        _batch = Batch::Cooling;
+        setFan(255);
+        return;
+    }
+    _finished = true;
+}
+
+/**
+ * @brief Preheat & hold (if configured): The profile bound channels regulate at the hold temp until the next start
+ */
+void Profile::startHold()
+{
+    Segment seg;
+
+    _holdTemp_c = 0;
+    switch (Config::active.standby_hold)
+    {
+    case Hold::Soak:
+        for (uint8_t i = 0; getSegment(i, seg); i++)
+        {
+            if (seg.type == SegmentType::HoldTime)
+            {
+                _holdTemp_c = seg.temp_c;
+                break;
+            }
+        }
+        break;
+    case Hold::Custom:
+        _holdTemp_c = Config::active.standby_temp_c;
+        break;
+    default:
+        break;
+    }
+    if (!_holdTemp_c)
+    {
+        return;
+    }
+
+    dispatchBoundChannels(Hotplate::Event::Profile);
+    for (Hotplate &hotplate : hotplates)
+    {
+        hotplate.setProfileSetpoint(_holdTemp_c);
+    }
+}
+
+/**
+ * @brief Batch cool down gating: Ready for the next run if the (lead channel) plate is below the ready temp,
+ * resp. within the band of the hold temp
+ */
+void Profile::batchLoop()
+{
+    uint8_t readyTemp_c = _holdTemp_c ? _holdTemp_c + PROFILE_TEMP_BAND_C : Config::active.batch_ready_temp_c;
+
+    if (_batch == Batch::Cooling && thermocouples[0].getTemperatureAverage() < readyTemp_c)
+    {
+        _batch = Batch::Ready;
+        setFan(0);
+    }
+}
+
+/**
+ * @brief Open loop fan duty (0..255), if there's a fan (FAN_PIN)
+ */
+void Profile::setFan(uint8_t duty)
+{
+#ifdef FAN_PIN
+    fan.setDuty(duty);
+#endif
+}
+
+/**
+ * @brief Did the profile run to the end (since the last call)? I.e. to show the run summary
+ */
+bool Profile::consumeFinished()
+{
+    bool finished = _finished;
+    _finished = false;
+    return finished;
+}
+
+/**
+ * @brief Dispatch an event to all channels which follow the profile
+ */
+void Profile::dispatchBoundChannels(Hotplate::Event ev)
+{
+    for (Hotplate &hotplate : hotplates)
+    {
+        if (hotplate.isProfileBound())
+        {
+            hotplate.dispatch(ev);
+        }
+    }
+}
+
+/**
+ * @brief Copy segment idx of the active profile from flash
+ *
+ * @return false if there's no such segment (profile end)
+ */
+bool Profile::getSegment(uint8_t idx, Segment &seg, SegmentPlan *plan)
+{
+    ProfileSegments ps;
+
+    memcpy_P(&ps, &_profileSegments[_metrics.profile], sizeof(ps));
+    if (idx >= ps.length)
+    {
+        return false;
+    }
+    memcpy_P(&seg, &ps.segments[idx], sizeof(seg));
+    if (plan)
+    {
+        memcpy_P(plan, &ps.plans[idx], sizeof(*plan));
+    }
+    return true;
+}
+
+/**
+ * @brief Warm start: Skip the leading segments which the plate temperature is already beyond,
+ * so that the run begins where temp_dc sits on the profile curve. The setpoint curve starts at
+ * temp_dc as well, thus getSecondsLeft() keeps consistent. Peak, dwell and cool segments never get skipped.
+ *
+ * @param held true if the plate got held at the hold temp: Within band counts as reached, and the soak
+ * at the hold temp gets skipped as well (the next segment starts with its own timing)
+ */
+void Profile::seekSegment(int16_t temp_dc, bool held)
+{
+    Segment seg;
+    int16_t band_dc = held ? 10 * PROFILE_TEMP_BAND_C : 0;
+
+    while (getSegment(_segment, seg))
+    {
+        if (seg.type == SegmentType::RampRate && temp_dc + band_dc < 10 * seg.temp_c)
+            break; // Ramp not yet done
+        if (seg.type == SegmentType::HoldTime && (temp_dc + band_dc < 10 * seg.temp_c ||
+                                                  (!held && temp_dc <= 10 * (seg.temp_c + PROFILE_TEMP_BAND_C))))
+            break; // Below, resp. (if not held) within the soak temp
+        if (seg.type != SegmentType::RampRate && seg.type != SegmentType::HoldTime)
+            break;
+        _segment++;
+    }
+}
+
+/**
+ * @brief Update the run metrics with the current temperature, once per PROFILE_STEP_MS
+ */
+void Profile::updateMetrics(uint32_t now)
+{
+    int16_t temp_dc = thermocouples[0].getTemperatureAverage() * 10;
+    uint32_t elapsed_ms = now - _profileStart_ms;
+    uint16_t deviation_dc = abs(temp_dc - _setpoint_dc);
+    int16_t ramp_dcs = (int32_t)(temp_dc - _lastTemp_dc) * 1000 / PROFILE_STEP_MS;
+
+    if (temp_dc > _metrics.peak_dc)
+        _metrics.peak_dc = temp_dc;
+    if (temp_dc >= 10 * pgm_read_byte(&_profileSegments[_metrics.profile].liquidus_c))
+        _metrics.aboveLiquidus_s += PROFILE_STEP_MS / 1000;
+    if (ramp_dcs > _metrics.maxRamp_dcs)
+        _metrics.maxRamp_dcs = ramp_dcs;
+    if (deviation_dc > _metrics.maxDeviation_dc)
+        _metrics.maxDeviation_dc = deviation_dc;
+    _metrics.iae_dcs += (uint32_t)deviation_dc * PROFILE_STEP_MS / 1000;
+    while ((uint32_t)(_metrics.duration_s + 1) * 1000 <= elapsed_ms) // Instead of elapsed_ms / 1000. Steps are >= 1 s apart
+    {
+        _metrics.duration_s++;
+    }
+
+    // Energy = SSR on-time * heater power. ms * 10 W / 3600000 ms/h = 1/10 Wh per 36000 ms and 10 W.
+    // Accumulated per step with remainder instead of a division (a few iterations per step)
+    uint32_t onTime_ms = 0;
+    for (uint8_t i = 0; i < HOTPLATE_CHANNELS; i++)
+    {
+        if (hotplates[i].isProfileBound())
+        {
+            onTime_ms += hotplates[i].getOnTime_ms() - _startOnTime_ms[i];
+        }
+    }
+    _energyRest += (onTime_ms - _energyOnTime_ms) * Config::active.heater_10w;
+    _energyOnTime_ms = onTime_ms;
+    while (_energyRest >= 36000)
+    {
+        _energyRest -= 36000;
+        _metrics.energy_dWh++;
+    }
+    _metrics.switches = hotplates[0].getSwitches() - _startSwitches;
+#ifdef LIVE_GRAPH
+    graph.record(temp_dc, _setpoint_dc);
+#endif
+
+    _lastTemp_dc = temp_dc;
+}
+
+/**
+ * @brief Average SSR duty (lead channel) of the active segment, since its start
+ */
+void Profile::updateSegmentDuty(uint32_t now)
+{
+    uint32_t elapsed_ms = now - _segmentStart_ms;
+
+    if (_segment < pgm_read_byte(&_profileSegments[_metrics.profile].length) && elapsed_ms)
+    {
+        _metrics.segmentDuty[_segment] = min((hotplates[0].getOnTime_ms() - _segmentOnTime_ms) * 100 / elapsed_ms, (uint32_t)100);
+    }
+}
+
+void Profile::printRunMetrics(const RunMetrics &m)
+{
+    char name[PROFILE_NAME_SIZE];
+
+    Serial.print(F("Run: "));
+    Serial.print(getName(name, m.profile));
+    Serial.print(F(", duration(s): "));
+    Serial.print(m.duration_s);
+    Serial.print(F(", peak(C): "));
+    Serial.print(0.1 * m.peak_dc, 1);
+    Serial.print(F(", above liquidus(s): "));
+    Serial.print(m.aboveLiquidus_s);
+    Serial.print(F(", max. ramp(C/s): "));
+    Serial.print(0.1 * m.maxRamp_dcs, 1);
+    Serial.print(F(", max. deviation(C): "));
+    Serial.print(0.1 * m.maxDeviation_dc, 1);
+    Serial.print(F(", IAE(C*s): "));
+    Serial.print(m.iae_dcs / 10);
+    Serial.print(F(", energy(Wh): "));
+    Serial.print(0.1 * m.energy_dWh, 1);
+    Serial.print(F(", SSR switches: "));
+    Serial.print(m.switches);
+    Serial.print(F(", duty/segment(%):"));
+    for (uint8_t i = 0; i < pgm_read_byte(&_profileSegments[m.profile].length); i++)
+    {
+        Serial.print(' ');
+        if (m.segmentDuty[i] == PROFILE_DUTY_SKIPPED)
+            Serial.print('-');
+        else
+            Serial.print(m.segmentDuty[i]);
+    }
+    Serial.println();
 }
 
 /**
@@ -50,111 +545,162 @@ void Profile::stopProfile()
  */
 bool Profile::isStandBy()
 {
-    return (Config::active.profile != Profile::Profiles::Manual && !_profileStart_ms);
+    return (Config::active.profile != Profile::Profiles::Manual && !_profileStart_ms && _batch != Batch::Cooling);
 }
 
+/**
+ * @brief High temp. profiles exceed the default max_temp_c (see PROFILE_CHECKS()), and max_temp_c is a setting.
+ * Instead of clamping the peak silently (which fails the reflow), such a profile doesn't start.
+ */
+bool Profile::isAboveMaxTemp()
+{
+    return pgm_read_byte(&_profileSegments[Config::active.profile].peak_c) > Config::active.max_temp_c;
+}
+
+/**
+ * @brief Estimated time position, relative to the (estimated) profile end
+ *
+ * @return Negative seconds until the profile end (0 if not running)
+ */
 short Profile::getSecondsLeft()
 {
-    // In-line math in C sucks!
-    long timePosMs = millis() - _profileStart_ms - (1000UL * _profile2timeTargets[Config::active.profile]->duration_s);
-    short timePosS = round(0.001 * timePosMs);
-
-#ifdef DEBUG_SERIAL_PROTIMPOS
-    Serial.print("millis(): ");
-    Serial.print(millis());
-    Serial.print(", profile start(ms): ");
-    Serial.print(_profileStart_ms);
-    Serial.print(", profile duration(s): ");
-    Serial.print(_profile2timeTargets[Config::active.profile]->duration_s);
-    Serial.print(", timePosMs: ");
-    Serial.print(timePosMs);
-    Serial.println(", timePosS: ");
-#endif
+    Segment seg;
+    SegmentPlan plan;
+    uint32_t left_s = 0;
+    uint16_t elapsed_s = _segmentSteps * (PROFILE_STEP_MS / 1000);
+
+    if (!_profileStart_ms || !getSegment(_segment, seg, &plan))
+    {
+        return 0;
+    }
 
-    return timePosS;
+    switch (seg.type)
+    {
+    case SegmentType::RampRate:
+    case SegmentType::CoolRate:
+        left_s = ((uint32_t)abs(10 * seg.temp_c - _setpoint_dc) * plan.invRate) >> PROFILE_RATE_SHIFT;
+        break;
+    case SegmentType::HoldTime:
+        left_s = seg.time_s > elapsed_s ? seg.time_s - elapsed_s : 0;
+        break;
+    case SegmentType::Dwell:
+        left_s = seg.time_s - min(seg.time_s, _dwell_s);
+        break;
+    case SegmentType::HoldTemp:
+        break;
+    }
+    left_s += plan.after_s; // Following segments, precomputed
+
+    return -(short)min(left_s, (uint32_t)INT16_MAX);
 }
 
-void Profile::loop()
+/**
+ * @brief Segment interpreter, once per PROFILE_STEP_MS. Calculates the profile curve (setpoint)
+ * and switches to the next segment on its time and/or temperature condition.
+ */
+void Profile::runSegment(uint32_t now)
 {
-    uint32_t now = millis();
-    if (now < _nextInterval_ms)
+    Segment seg;
+    SegmentPlan plan;
+    int16_t temp_dc = thermocouples[0].getTemperatureAverage() * 10; // Lead channel
+    uint16_t elapsed_s = _segmentSteps * (PROFILE_STEP_MS / 1000);
+    bool done = false;
+
+    if (!getSegment(_segment, seg, &plan))
     {
+        finishProfile();
         return;
     }
-    _nextInterval_ms = now + PROFILE_TIME_INTERVAL_MS;
 
-    if (Config::active.profile == Profile::Profiles::Manual || !_profileStart_ms) // Not the same as: isStandBy()
+    int16_t target_dc = 10 * seg.temp_c;
+    int16_t step_dc = plan.step_dc;
+
+    switch (seg.type)
     {
-        return;
+    case SegmentType::RampRate:
+        _setpoint_dc = min(_setpoint_dc + step_dc, target_dc);
+        done = temp_dc >= target_dc;
+        break;
+    case SegmentType::CoolRate:
+        _setpoint_dc = max(_setpoint_dc - step_dc, target_dc);
+        done = temp_dc <= target_dc;
+#ifdef FAN_PIN
+        fan.trackRate(temp_dc, _setpoint_dc, seg.arg, PROFILE_STEP_MS);
+#endif
+        break;
+    case SegmentType::HoldTime:
+        _setpoint_dc = target_dc;
+        done = elapsed_s >= seg.time_s;
+        break;
+    case SegmentType::HoldTemp:
+        _setpoint_dc = target_dc;
+        done = abs(temp_dc - target_dc) <= 10 * PROFILE_TEMP_BAND_C;
+        break;
+    case SegmentType::Dwell:
+        _setpoint_dc = target_dc;
+        if (temp_dc >= 10 * seg.arg)
+            _dwell_s += PROFILE_STEP_MS / 1000;
+        done = _dwell_s >= seg.time_s;
+        break;
     }
 
-    short nextTemp = getTempTarget();
-    if (!nextTemp)
+    // Timeout of the temperature triggered segments, and safety net for all
+    if ((seg.time_s && seg.type != SegmentType::HoldTime && seg.type != SegmentType::Dwell && elapsed_s >= seg.time_s) ||
+        elapsed_s >= PROFILE_SEGMENT_MAX_S)
     {
-        return;
+        done = true;
+    }
+
+    for (Hotplate &hotplate : hotplates)
+    {
+        hotplate.setProfileSetpoint((_setpoint_dc + 5) / 10);
     }
 
-    hotplate.setSetpoint(nextTemp);
+    if (done)
+    {
+        setFan(0);
+        updateSegmentDuty(now);
+        _segment++;
+        _segmentStart_ms = now;
+        _segmentSteps = 0;
+        _segmentOnTime_ms = hotplates[0].getOnTime_ms();
+        _dwell_s = 0;
+    }
+    _segmentSteps++;
 }
 
-/**
- * @brief Get profile time/temp target dependent of current time & temp
- * @return 0 in the case where PROFILE_TIME_INTERVAL is not reached or profile ended
- */
-uint16_t Profile::getTempTarget()
+void Profile::loop()
 {
     uint32_t now = millis();
-    uint16_t nextTemp;
-    ProfileTimeTarget timeTarget;
-    uint32_t targetTime_ms;
-
-    for (uint8_t i = 0; i < _profile2timeTargets[Config::active.profile]->length; i++)
-    {
-        timeTarget = _profile2timeTargets[Config::active.profile]->timeTargets[i]; // Make code more readable
-
-#ifdef DEBUG_SERIAL_PROTEM
-        Serial.print("Profile: ");
-        Serial.print(Config::active.profile);
-        Serial.print(" = ");
-        Serial.print(Hotplate::profile2str[Config::active.profile]);
-        Serial.print(": time_s = ");
-        Serial.print(timeTarget.time_s);
-        Serial.print(", temp_c = ");
-        Serial.println(timeTarget.temp_c);
-#endif
 
-        targetTime_ms = 1000UL * timeTarget.time_s;
-        if ((now - _profileStart_ms) > targetTime_ms ||
-            thermocouple.getTemperatureAverage() > timeTarget.temp_c) // FIXME: This would result in a wrong profile time left display if already hot
-        {
-            continue; // Already beyond this time or temp target
-        }
+    if (_printMetrics)
+    {
+        _printMetrics = false;
+        printRunMetrics(_metrics);
+    }
 
-        // In-line math in C sucks :-/
-        float tempDiff = timeTarget.temp_c - thermocouple.getTemperatureAverage();
-        float timeLeft_ms = targetTime_ms + _profileStart_ms - now;
-        float intervalsProfile = targetTime_ms / PROFILE_TIME_INTERVAL_MS;
-        float intervalsLeft = (timeLeft_ms / PROFILE_TIME_INTERVAL_MS) - 1;
-
-        nextTemp = thermocouple.getTemperatureAverage() + round(tempDiff / intervalsProfile * (intervalsProfile - intervalsLeft));
-
-#ifdef DEBUG_SERIAL_PROTEM
-        Serial.print("TimeTarget = ");
-        Serial.print(i);
-        Serial.print(": tempDiff = ");
-        Serial.print(tempDiff);
-        Serial.print(", timeLeft(ms) = ");
-        Serial.print(timeLeft_ms);
-        Serial.print(", intervals = ");
-        Serial.print(intervalsProfile);
-        Serial.print(", intervalsLeft = ");
-        Serial.print(intervalsLeft);
-        Serial.print(", new Setpoint = ");
-        Serial.println(nextTemp);
-#endif
+    batchLoop();
+
+    if (Config::active.profile == Profile::Profiles::Manual || !_profileStart_ms) // Not the same as: isStandBy()
+    {
+        return;
+    }
 
-        return nextTemp;
+    if (hotplates[0].isState(Hotplate::State::Fault)) // Lead channel
+    {
+        stopProfile();
+        return;
     }
 
-    return 0; // Profile ended
-}
\ No newline at end of file
+    if (now < _nextStep_ms)
+    {
+        return;
+    }
+    _nextStep_ms = now + PROFILE_STEP_MS;
+
+    runSegment(now);
+    if (_profileStart_ms) // Not finished by the last segment
+    {
+        updateMetrics(now);
+    }
+}
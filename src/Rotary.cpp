@@ -0,0 +1,72 @@
+/*
+ * This file is part of the Another-Reflow-HotPlate-Firmware project (https://github.com/Apehaenger/Another-Reflow-HotPlate-Firmware).
+ * Copyright (c) 2022 Jörg Ebeling
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "config.hpp"
+#include "Rotary.hpp"
+
+/*
+ * Index = last A/B << 2 | current A/B. CW = 00 -> 10 -> 11 -> 01 -> 00 (A leads B), same as the former A rising edge logic
+ */
+static const int8_t transitionTable[16] PROGMEM = {
+    0, -1, 1, 0,  // From 00
+    1, 0, 0, -1,  // From 01
+    -1, 0, 0, 1,  // From 10
+    0, 1, -1, 0}; // From 11
+
+/**
+ * @brief Velocity based step multiplier, dependent of the time since the last detent (in the same direction)
+ */
+uint8_t Rotary::getMultiplier(int8_t dir, uint32_t now_ms)
+{
+    uint32_t interval_ms = now_ms - _lastDetent_ms;
+    bool sameDir = (dir == _lastDir);
+
+    _lastDetent_ms = now_ms;
+    _lastDir = dir;
+
+    if (!sameDir)
+        return 1;
+    if (interval_ms < Config::active.rotary_accel_fast_ms)
+        return Config::active.rotary_accel_fast_steps;
+    if (interval_ms < Config::active.rotary_accel_medium_ms)
+        return Config::active.rotary_accel_medium_steps;
+    return 1;
+}
+
+/**
+ * @brief Feed a new A/B state. To be called on every pin change (ISR)
+ *
+ * @param ab A/B level (A = bit1, B = bit0)
+ * @return Steps of a completed detent (> 0 = CW, < 0 = CCW, incl. acceleration), 0 if none
+ */
+int8_t Rotary::update(uint8_t ab, uint32_t now_ms)
+{
+    ab &= 0x03;
+    _transitions += (int8_t)pgm_read_byte(&transitionTable[(_ab << 2) | ab]);
+    _ab = ab;
+
+    if (_transitions >= ROTARY_TRANSITIONS_PER_DETENT)
+    {
+        _transitions = 0;
+        return getMultiplier(1, now_ms);
+    }
+    if (_transitions <= -ROTARY_TRANSITIONS_PER_DETENT)
+    {
+        _transitions = 0;
+        return -getMultiplier(-1, now_ms);
+    }
+    return 0;
+}
@@ -0,0 +1,245 @@
+/*
+ * This file is part of the Another-HotPlate-Firmware project (https://github.com/Apehaenger/Another-HotPlate-Firmware).
+ * Copyright (c) 2022 Jörg Ebeling
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <Arduino.h>
+#include <EEPROM.h>
+#include "main.hpp"
+#include "config.hpp"
+#include "RunLog.hpp"
+
+static_assert(sizeof(Config::EEPConfig) <= RUNLOG_SWITCHES_ADDR, "Config overlaps the run log");
+
+/**
+ * @brief Find the slot behind the one with the highest sequence number
+ */
+void RunLog::setup()
+{
+    uint16_t seq;
+
+    for (uint8_t i = 0; i < HOTPLATE_CHANNELS; i++)
+    {
+        EEPROM.get(RUNLOG_SWITCHES_ADDR + i * sizeof(uint32_t), _switchesBase[i]);
+        if (_switchesBase[i] == 0xFFFFFFFF) // Erased EEPROM
+        {
+            _switchesBase[i] = 0;
+        }
+        _switchesSaved[i] = _switchesBase[i];
+    }
+
+    for (uint8_t slot = 0; slot < RUNLOG_SLOTS; slot++)
+    {
+        EEPROM.get(slotAddr(slot), seq);
+        if (seq != 0xFFFF && seq >= _nextSeq)
+        {
+            _nextSeq = seq + 1;
+            _nextSlot = (slot + 1) % RUNLOG_SLOTS;
+        }
+    }
+}
+
+void RunLog::loop()
+{
+    saveSwitches();
+
+    if (!_logging)
+    {
+        if (profile.isRunning())
+        {
+            start();
+        }
+        return;
+    }
+
+    if (!profile.isRunning())
+    {
+        finish();
+        return;
+    }
+
+    if (millis() >= _nextSample_ms)
+    {
+        _nextSample_ms += RUNLOG_SAMPLE_INTERVAL_MS;
+        writeSample();
+    }
+}
+
+void RunLog::start()
+{
+    Header h;
+
+    _slot = _nextSlot;
+    _nextSlot = (_nextSlot + 1) % RUNLOG_SLOTS;
+
+    h.seq = _nextSeq++;
+    h.startTemp_c = constrain((int16_t)thermocouples[0].getTemperatureAverage(), 0, 255);
+    _logTemp_c = h.startTemp_c;
+
+    // Only the first bytes of the header (metrics get written by finish())
+    EEPROM.put(slotAddr(_slot), h.seq);
+    EEPROM.update(slotAddr(_slot) + offsetof(Header, startTemp_c), h.startTemp_c);
+    EEPROM.update(slotAddr(_slot) + offsetof(Header, complete), RUNLOG_END_MARK);
+
+    _sampleAddr = slotAddr(_slot) + sizeof(Header);
+    EEPROM.update(_sampleAddr, RUNLOG_END_MARK);
+
+    _nextSample_ms = millis() + RUNLOG_SAMPLE_INTERVAL_MS;
+    _logging = true;
+}
+
+/**
+ * @brief Append one delta encoded sample. The encoder tracks the reconstructed temperature,
+ * so clamped deltas (fast ramps) catch up with the next samples instead of accumulating an error.
+ */
+void RunLog::writeSample()
+{
+    uint16_t slotEnd = slotAddr(_slot) + RUNLOG_SLOT_SIZE;
+    if (_sampleAddr >= slotEnd)
+    {
+        return; // Slot full
+    }
+
+    int16_t diff = (int16_t)(thermocouples[0].getTemperatureAverage() + 0.5) - _logTemp_c;
+    int8_t delta = constrain((diff + (diff >= 0 ? 1 : -1) * RUNLOG_TEMP_STEP_C / 2) / RUNLOG_TEMP_STEP_C, -8, 7);
+    _logTemp_c += delta * RUNLOG_TEMP_STEP_C;
+
+    uint8_t duty = (uint32_t)min(hotplates[0].getOutput(), Config::active.pid_pwm_window_ms) * RUNLOG_DUTY_MAX / Config::active.pid_pwm_window_ms;
+
+    EEPROM.update(_sampleAddr++, (uint8_t)(delta << 4) | duty);
+    if (_sampleAddr < slotEnd)
+    {
+        EEPROM.update(_sampleAddr, RUNLOG_END_MARK);
+    }
+}
+
+void RunLog::finish()
+{
+    EEPROM.put(slotAddr(_slot) + offsetof(Header, metrics), profile.getRunMetrics());
+    EEPROM.update(slotAddr(_slot) + offsetof(Header, complete), 1);
+    _logging = false;
+
+    Serial.print(F("SSR lifetime switches:"));
+    for (uint8_t i = 0; i < HOTPLATE_CHANNELS; i++)
+    {
+        Serial.print(' ');
+        Serial.print(getLifetimeSwitches(i));
+    }
+    Serial.println();
+}
+
+/**
+ * @brief Save the lifetime SSR switch count of each channel which grew by RUNLOG_SWITCHES_SAVE_STEP,
+ * or which got stopped (standby or fault) with unsaved switches. Independent of the mode (manual, profile, tuner).
+ */
+void RunLog::saveSwitches()
+{
+    for (uint8_t i = 0; i < HOTPLATE_CHANNELS; i++)
+    {
+        uint32_t switches = getLifetimeSwitches(i);
+        if (switches == _switchesSaved[i])
+        {
+            continue;
+        }
+
+        Hotplate::State state = hotplates[i].getState();
+        if (switches - _switchesSaved[i] >= RUNLOG_SWITCHES_SAVE_STEP ||
+            state == Hotplate::State::StandBy || state == Hotplate::State::Fault)
+        {
+            EEPROM.put(RUNLOG_SWITCHES_ADDR + i * sizeof(uint32_t), switches);
+            _switchesSaved[i] = switches;
+        }
+    }
+}
+
+uint32_t RunLog::getLifetimeSwitches(uint8_t channel)
+{
+    return _switchesBase[channel] + hotplates[channel].getSwitches();
+}
+
+void RunLog::printSlot(uint8_t slot)
+{
+    Header h;
+    uint8_t sample;
+    int16_t temp_c;
+
+    EEPROM.get(slotAddr(slot), h);
+
+    Serial.print(F("Run #"));
+    Serial.print(h.seq);
+    Serial.print(F(" "));
+    if (h.complete == RUNLOG_END_MARK)
+    {
+        Serial.println(F("(incomplete)"));
+    }
+    else
+    {
+        profile.printRunMetrics(h.metrics);
+    }
+
+    Serial.println(F("Time(s), Temp(C), Duty(%)"));
+    temp_c = h.startTemp_c;
+    for (uint16_t i = 0, addr = slotAddr(slot) + sizeof(Header); addr < slotAddr(slot) + RUNLOG_SLOT_SIZE; i++, addr++)
+    {
+        sample = EEPROM.read(addr);
+        if (sample == RUNLOG_END_MARK)
+        {
+            break;
+        }
+        temp_c += (int8_t)(sample & 0xF0) / 16 * RUNLOG_TEMP_STEP_C; // Sign extended high nibble
+        Serial.print((i + 1) * (RUNLOG_SAMPLE_INTERVAL_MS / 1000));
+        Serial.print(F(", "));
+        Serial.print(temp_c);
+        Serial.print(F(", "));
+        Serial.println((sample & 0x0F) * 100 / RUNLOG_DUTY_MAX);
+    }
+}
+
+static bool isHeating()
+{
+    for (Hotplate &hotplate : hotplates)
+    {
+        if (hotplate.getSetpoint())
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief Print all logged runs, oldest first.
+ * Serial output of all runs takes a couple of seconds, thus it's refused while heating.
+ */
+void RunLog::print()
+{
+    uint16_t seq;
+
+    if (isHeating())
+    {
+        Serial.println(F("Run log: Stop heating first"));
+        return;
+    }
+
+    for (uint8_t i = 0; i < RUNLOG_SLOTS; i++)
+    {
+        uint8_t slot = (_nextSlot + i) % RUNLOG_SLOTS;
+        EEPROM.get(slotAddr(slot), seq);
+        if (seq == 0xFFFF)
+        {
+            continue; // Empty
+        }
+        printSlot(slot);
+    }
+}
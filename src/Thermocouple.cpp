@@ -16,7 +16,7 @@
  */
 #include "Thermocouple.hpp"
 
-Thermocouple::Thermocouple(const int8_t pin_CLK, const int8_t pin_CS, const int8_t pin_DO) : _Tc(pin_CLK, pin_CS, pin_DO) {}
+Thermocouple::Thermocouple(const int8_t pin_CS) : _Tc(pin_CS) {}
 
 void Thermocouple::readTemperature()
 {
@@ -29,6 +29,13 @@ void Thermocouple::readTemperature()
     // TODO: Read temperate dependent on EEPROM unit setting (C/F)
     _lastTemp = _Tc.readCelsius();
 
+    // A fault (NAN) propagates to the average, which restarts at the first valid read afterwards
+    if (isnan(_avgTemp))
+    {
+        _avgTemp = _lastTemp;
+        return;
+    }
+
     // Cumulative (rolling) average temperature of the last TC_AVG_SAMPLES
     // See https://en.wikipedia.org/wiki/Moving_average#Cumulative_average
     _avgTemp -= _avgTemp / TC_AVG_SAMPLES;
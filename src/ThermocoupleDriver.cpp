@@ -0,0 +1,150 @@
+/*
+ * This file is part of the Another-Reflow-HotPlate-Firmware project (https://github.com/Apehaenger/Another-Reflow-HotPlate-Firmware).
+ * Copyright (c) 2022 Jörg Ebeling
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "main.hpp"
+#include "FastGpio.hpp"
+#include "ThermocoupleDriver.hpp"
+
+typedef FastPin<TC_CLK_PIN> TcClk;
+typedef FastPin<TC_DO_PIN> TcDo; // Chip output (MISO)
+typedef FastPin<TC_DI_PIN> TcDi; // Chip input (MOSI)
+
+/**
+ * @brief Init CS (per channel, runtime pin) and the shared bus pins. CLK idles low
+ */
+void SoftSpiDevice::beginSpi(bool withDi)
+{
+    digitalWrite(_cs, HIGH);
+    pinMode(_cs, OUTPUT);
+    TcClk::low();
+    TcClk::output();
+    TcDo::input();
+    if (withDi)
+    {
+        TcDi::output();
+    }
+}
+
+/**
+ * @brief Read a frame of up to 32 bits, MSB first. SPI mode 0: Chip shifts out on falling CLK edge, the first bit on CS low.
+ */
+uint32_t SoftSpiDevice::readMode0(uint8_t bits)
+{
+    uint32_t frame = 0;
+
+    for (uint8_t i = 0; i < bits; i++)
+    {
+        frame <<= 1;
+        if (TcDo::read())
+        {
+            frame |= 1;
+        }
+        TcClk::high();
+        TcClk::low();
+    }
+    return frame;
+}
+
+/**
+ * @brief Transfer one byte, MSB first. SPI mode 1: Chip shifts out on rising CLK edge and samples DI on falling edge.
+ */
+uint8_t SoftSpiDevice::transferMode1(uint8_t out)
+{
+    uint8_t in = 0;
+
+    for (uint8_t mask = 0x80; mask; mask >>= 1)
+    {
+        TcDi::write(out & mask);
+        TcClk::high();
+        TcClk::low();
+        if (TcDo::read())
+        {
+            in |= mask;
+        }
+    }
+    return in;
+}
+
+// ----- MAX6675 -----
+
+float Max6675::readCelsius()
+{
+    select(true);
+    uint16_t frame = readMode0(16);
+    select(false); // Starts the next conversion
+
+    _fault = frame & FAULT_OPEN;
+    return decode(frame);
+}
+
+// ----- MAX31855 -----
+
+float Max31855::readCelsius()
+{
+    select(true);
+    uint32_t frame = readMode0(32);
+    select(false);
+
+    _fault = frame & (FAULT_OPEN | FAULT_SHORT_GND | FAULT_SHORT_VCC);
+    _coldJunction = decodeColdJunction(frame);
+    return decode(frame);
+}
+
+// ----- MAX31856 -----
+
+void Max31856::begin()
+{
+    beginSpi(true);
+    writeRegister(MASK, 0x00); // Unmask all faults (FAULT pin)
+    writeRegister(CR1, CR1_TYPE_K);
+    writeRegister(CR0, CR0_AUTOCONVERT | CR0_OCFAULT);
+}
+
+void Max31856::readRegisters(uint8_t reg, uint8_t *buf, uint8_t len)
+{
+    select(true);
+    transferMode1(reg);
+    while (len--)
+    {
+        *buf++ = transferMode1(0xFF);
+    }
+    select(false);
+}
+
+void Max31856::writeRegister(uint8_t reg, uint8_t value)
+{
+    select(true);
+    transferMode1(reg | WRITE);
+    transferMode1(value);
+    select(false);
+}
+
+float Max31856::readCelsius()
+{
+    uint8_t buf[4]; // LTCBH, LTCBM, LTCBL, SR
+
+    readRegisters(LTCBH, buf, sizeof(buf));
+    _fault = buf[3];
+    return _fault ? NAN : decode(buf[0], buf[1], buf[2]);
+}
+
+float Max31856::getColdJunction()
+{
+    uint8_t buf[2]; // CJTH, CJTL
+
+    readRegisters(CJTH, buf, sizeof(buf));
+    return ((int16_t)((uint16_t)buf[0] << 8 | buf[1]) >> 2) * 0.015625;
+}
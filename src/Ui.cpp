@@ -14,9 +14,10 @@
  * You should have received a copy of the GNU General Public License
  * along with this program. If not, see <http://www.gnu.org/licenses/>.
  */
-#include "CRC32.h"
 #include "main.hpp"
 #include "config.hpp"
+#include "Memory.hpp"
+#include "Format.hpp"
 #include "../assets/fonts/my_u8g2_font_7x13B.hpp"
 #include "../assets/fonts/my_u8g2_font_open_iconic_embedded_2x.hpp"
 #include "../assets/fonts/my_u8g2_font_fur20.hpp"
@@ -31,214 +32,644 @@ Ui::Ui() : u8g2(U8G2_R0, /* reset=*/U8X8_PIN_NONE) {}
 
 void Ui::setup()
 {
-    u8g2.begin(ROTARY_S_PIN, ROTARY_A_PIN, ROTARY_B_PIN);
+    u8g2.begin(); // Encoder inputs get handled by our own (non-blocking) setup, see input()
     u8g2.clear();
 }
 
+/**
+ * @brief Main screen, redrawn per tile row (8 pixel rows): Only the tile rows of the fields which changed since the last
+ * draw get rendered and transferred. There's no frame buffer (page mode, RAM), so the static parts (labels, unit,
+ * frames) get drawn along with the fields of the refreshed tile rows only.
+ */
 void Ui::displayMainScreen()
 {
-    // CRC32 of main screen relevant values
-    // Do it via struct and a single crc.calculate() call instead of multiple crc.update() calls which would be more expensive!
-    MainScreenCrcData crcData = {hotplate.getMode(), hotplate.getPower(), hotplate.getSetpoint(), hotplate.getState(),
-                                 profile.getSecondsLeft(), thermocouple.getTemperatureAverage()};
-    uint32_t mainScreenCrc = CRC32::calculate(&crcData, 1);
+    Hotplate &hotplate = hotplates[_channel];
+    float temp = thermocouples[_channel].getTemperatureAverage();
+    MainScreenFields f = {hotplate.getState(), Config::active.profile, profile.isStandBy(),
+                          profile.getBatch(), profile.getBatchDone(), hotplate.getSetpoint(), profile.getSecondsLeft(),
+                          hotplate.getControl(), hotplate.getOutput(),
+                          (int16_t)(isnan(temp) ? INT16_MIN : lround(temp * 10)), hotplate.getPower()};
+    uint8_t dirty = _mainScreenDirty;
+
+    if (f.hpState != _mainScreen.hpState || f.profile != _mainScreen.profile)
+        dirty = UI_MAIN_TILES_ALL;
+    if (f.standBy != _mainScreen.standBy || f.batch != _mainScreen.batch || f.batchDone != _mainScreen.batchDone ||
+        f.hpSetpoint != _mainScreen.hpSetpoint || f.profileSecLeft != _mainScreen.profileSecLeft)
+        dirty |= UI_MAIN_TILES_ROW2;
+    if (f.hpControl != _mainScreen.hpControl || f.hpOutput != _mainScreen.hpOutput)
+        dirty |= UI_MAIN_TILES_ROW3;
+    if (f.temp_dc != _mainScreen.temp_dc || f.hpPower != _mainScreen.hpPower)
+        dirty |= UI_MAIN_TILES_TEMP;
 
 #ifdef DEBUG_UI_SERIAL
-    Serial.print("mainScreenCrc: ");
-    Serial.print(mainScreenCrc, HEX);
-    Serial.print(", _lastMainScreenCrc: ");
-    Serial.println(_lastMainScreenCrc, HEX);
+    Serial.print(F("Main screen dirty tiles: "));
+    Serial.println(dirty, BIN);
 #endif
 
-    // Check if we need to make the expensive display redraw
-    if (mainScreenCrc == _lastMainScreenCrc)
+    if (!dirty)
     {
         return;
     }
-    _lastMainScreenCrc = mainScreenCrc;
+    _mainScreen = f;
+    _mainScreenDirty = 0;
 
-    char cbuf[14]; // Longest entry length = "PID ????/5000\0", before "Target: 123\0"
-    String s;
-    u8g2_uint_t x, y;
+    // Format the dynamic fields once, for all tile rows
+    Hotplate::StateInfo info;
+    bool profileUi; // Profile related rows (not within PID Tuner)
+    char row2[16];  // Longest entry = "Cooling 255/255\0"
+    char targetBuf[6], secLeftBuf[8], outputBuf[6], windowBuf[6], tempBuf[8];
+    const char *row2Str = row2, *tempStr = "  ---"; // Sensor fault
 
-    u8g2.firstPage();
-    do
+    hotplate.getStateInfo(info);
+    profileUi = !(info.flags & Hotplate::STATE_TUNER);
+
+    row2[0] = '\0';
+    if (info.hint[0])
     {
-        // Standard (small font)
-        setStdFont();
+        row2Str = info.hint;
+    }
+    else if (profileUi && (f.batch == Profile::Batch::Cooling || f.batch == Profile::Batch::Ready))
+    {
+        char num[4];
+        strcpy(row2, f.batch == Profile::Batch::Cooling ? "Cooling " : "Load "); // Ready, load next board
+        strcat(row2, formatNumber(num, sizeof(num), f.batchDone + (f.batch == Profile::Batch::Ready ? 1 : 0)));
+        strcat(row2, "/");
+        strcat(row2, formatNumber(num, sizeof(num), Config::active.batch_runs));
+    }
+    else if (profileUi && f.standBy)
+    {
+        row2Str = profile.isAboveMaxTemp() ? "Max. temp low" : "Push to start";
+    }
+    const char *target = formatNumber(targetBuf, sizeof(targetBuf), f.hpSetpoint, 3);
+    char *secLeft = formatNumber(secLeftBuf, sizeof(secLeftBuf) - 1, f.profileSecLeft, 3);
+    strcat(secLeft, "s");
+    const char *output = formatNumber(outputBuf, sizeof(outputBuf), f.hpOutput, 4);
+    const char *window = formatNumber(windowBuf, sizeof(windowBuf), Config::active.pid_pwm_window_ms, 4);
+    if (f.temp_dc != INT16_MIN)
+    {
+        tempStr = formatNumber(tempBuf, sizeof(tempBuf), f.temp_dc, 5, true);
+    }
 
-        // 1st row
-        y = 9;
-        // Mode
-        switch (hotplate.getMode())
+    for (uint8_t row = 0; row < UI_TILE_ROWS; row++)
+    {
+        if (!(dirty & (1 << row)))
         {
-        case Hotplate::Mode::PIDTuner:
-            u8g2.drawStr(0, y, "PID Tuner:");
-            x = 71;
-            switch (hotplate.getState())
-            {
-            case Hotplate::State::Wait:
-                u8g2.drawStr(x, y, "Wait...");
-                break;
-            case Hotplate::State::Heat:
-                u8g2.drawStr(x, y, "Heat...");
-                break;
-            case Hotplate::State::Settle:
-                u8g2.drawStr(x, y, "Settle...");
-                break;
-            default:
-                break;
-            }
-            break;
-        default:
-            u8g2.drawStr(0, y, profile.profile2str[Config::active.profile]);
-            break;
+            continue;
         }
+        u8g2.setBufferCurrTileRow(row);
+        u8g2.clearBuffer();
+        u8g2.setDrawColor(1);
+
+        // Standard (small font)
+        setStdFont();
+
+        // 1st row = State title, resp. profile
+        char name[PROFILE_NAME_SIZE];
+        u8g2.drawStr(0, 9, info.title[0] ? info.title : Profile::getName(name, f.profile));
 
-        // 2nd row
-        y = 25; // For two color display need to be >= 25
-        if (hotplate.isStandBy() || (!hotplate.isMode(Hotplate::Mode::PIDTuner) && profile.isStandBy()))
+        // 2nd row. For two color display y needs to be >= 25
+        if (row2Str[0])
         {
-            const char *cp = "Push to start";
-            u8g2.drawStr((u8g2.getDisplayWidth() - u8g2.getStrWidth(cp)) / 2, y, cp);
+            u8g2.drawStr((u8g2.getDisplayWidth() - u8g2.getStrWidth(row2Str)) / 2, 25, row2Str);
         }
         else
         {
-            // Target temperature
-            sprintf(cbuf, "Target: %3d", hotplate.getSetpoint());
-            // u8g2.drawFrame(u8g2.getStrWidth(cbuf) - (3 * 7) - 3, y - 12, (3 * 7) + 6, 15);
-            u8g2.drawStr(0, y, cbuf);
-            if (Config::active.profile != Profile::Profiles::Manual && !hotplate.isMode(Hotplate::Mode::PIDTuner))
+            // Target temperature (monospaced font: The value starts at char 8)
+            u8g2.drawStr(0, 25, "Target:");
+            u8g2.drawStr(8 * 7, 25, target);
+            if (profileUi && f.profile != Profile::Profiles::Manual)
             {
-                sprintf(cbuf, "%3ds", profile.getSecondsLeft());
-                u8g2.drawStr(85, y, cbuf);
+                u8g2.drawStr(85, 25, secLeft);
             }
         }
 
-        // Row 3 = Controller state
-        x = 1;
-        y = 40;
-        switch (hotplate.getState())
+        // Row 3 = Controller output
+        switch (f.hpControl)
         {
-        case Hotplate::State::BangOn:
-            strcpy(cbuf, "BangON");
+        case Hotplate::Control::BangOn:
             u8g2.setFontMode(0);
-            u8g2.setDrawColor(1);
-            u8g2.drawBox(0, 29, u8g2.getStrWidth(cbuf) + 2, 13);
+            u8g2.drawBox(0, 29, u8g2.getStrWidth("BangON") + 2, 13);
             u8g2.setDrawColor(0);
-            u8g2.drawStr(x, y, cbuf);
+            u8g2.drawStr(1, 40, "BangON");
+            u8g2.setDrawColor(1);
             break;
-        case Hotplate::State::PID:
-            sprintf(cbuf, "PID %4d/%4d", hotplate.getOutput(), Config::active.pid_pwm_window_ms);
-            u8g2.drawStr(x, y, cbuf);
+        case Hotplate::Control::PID:
+            u8g2.drawStr(1, 40, "PID");
+            u8g2.drawStr(1 + 4 * 7, 40, output);
+            u8g2.drawStr(1 + 8 * 7, 40, "/");
+            u8g2.drawStr(1 + 9 * 7, 40, window);
             break;
-        case Hotplate::State::BangOff:
-            u8g2.drawStr(x, y, "BangOFF");
+        case Hotplate::Control::BangOff:
+            u8g2.drawStr(1, 40, "BangOFF");
             break;
         default:
             break;
         }
+#if HOTPLATE_CHANNELS > 1
+        char channel[3] = {'#', (char)('1' + _channel), '\0'};
+        u8g2.drawStr(114, 40, channel);
+#endif
 
         // Unit
-        u8g2.setDrawColor(1);
         u8g2.drawUTF8(108, 62, "°C");
 
         // ----- Large font stuff -----
         u8g2.setFont(my_u8g2_font_fur20);
 
         // Temperature
-        dtostrf(thermocouple.getTemperatureAverage(), 5, 1, cbuf);
-        u8g2.drawUTF8(35, 64, cbuf);
+        u8g2.drawStr(35, 64, tempStr);
 
         // SSR Power
-        if (hotplate.getPower())
+        if (f.hpPower)
         {
             u8g2.setFont(my_u8g2_font_open_iconic_embedded_2x);
             u8g2.drawStr(5, 62, "C"); // Power symbol = 67 = C
         }
 
-    } while (u8g2.nextPage());
+        u8g2.sendBuffer();
+    }
 }
 
-void Ui::userInterfaceInputDouble(const char *title, const char *pre, double *value, uint8_t numInt, uint8_t numDec, const char *post)
+/*
+ * Setup menu tables
+ */
+enum SetupMenuEntry : uint8_t
 {
-    uint8_t iV;
-    String valueStr = "", prePart, postPart;
-
-    // Double -> String
-    char cbuf[numInt + numDec + 1];
-    if (*value == 0)
-    {
-        for (uint8_t i = 0; i < numInt; i++)
-            valueStr += "0";
-        valueStr += ".";
-        for (uint8_t i = 0; i < numDec; i++)
-            valueStr += "0";
-    }
-    else
+    ReflowProfile,
+    ProfileStart,
+    StandbyHold,
+    DisplayUnit,
+    SsrType,
+    HeaterPower,
+    MaxTemp,
+    SlewRate,
+    PidConstants,
+    BangBang,
+    Batch,
+    PidTuner,
+    MemoryInfo,
+    LastRun,
+#ifdef LIVE_GRAPH
+    RunGraph,
+#endif
+#if HOTPLATE_CHANNELS > 1
+    Channel,
+#endif
+    LoadSaved,
+    SaveQuit,
+    Quit,
+};
+
+static const char setupMenuEntries[][UI_ENTRY_SIZE] PROGMEM = { // In SetupMenuEntry order
+    "Reflow Profile",   // ReflowProfile
+    "Profile start",    // ProfileStart
+    "Standby hold",     // StandbyHold
+    "(Display unit)",   // DisplayUnit
+    "SSR Type",         // SsrType
+    "Heater power",     // HeaterPower
+    "Max. Temperature", // MaxTemp
+    "Setpoint slew",    // SlewRate
+    "PID constants",    // PidConstants
+    "BangBang",         // BangBang
+    "Batch",            // Batch
+    "PID Tuner",        // PidTuner
+    "Memory",           // MemoryInfo
+    "Last run",         // LastRun
+#ifdef LIVE_GRAPH
+    "Graph",            // RunGraph
+#endif
+#if HOTPLATE_CHANNELS > 1
+    "Channel",          // Channel
+#endif
+    "Load saved",       // LoadSaved
+    "Save & Quit",      // SaveQuit
+    "Quit",             // Quit
+};
+static_assert(sizeof(setupMenuEntries) / sizeof(setupMenuEntries[0]) == Quit + 1, "setupMenuEntries: Not one per SetupMenuEntry");
+
+static const char profileStartEntries[][UI_ENTRY_SIZE] PROGMEM = {"Cold (full)", "Warm (at temp)"};
+static const char standbyHoldEntries[][UI_ENTRY_SIZE] PROGMEM = {"Off", "Profile soak", "Custom temp"};
+static const char ssrTypeEntries[][UI_ENTRY_SIZE] PROGMEM = {"Active Low", "Active High"};
+#if HOTPLATE_CHANNELS > 1
+static const char channelEntries[][UI_ENTRY_SIZE] PROGMEM = {"Channel 1", "Channel 2"};
+#endif
+static_assert(PROFILE_NAME_SIZE <= UI_ENTRY_SIZE, "Profile names don't fit the selection list");
+
+#define UI_LIST(entries) entries[0], sizeof(entries[0]), sizeof(entries) / sizeof(entries[0]) // drawSelectionList() args
+
+/**
+ * @brief PID gains are shared by all channels
+ */
+static void updatePidGains()
+{
+    for (Hotplate &hotplate : hotplates)
     {
-        dtostrf(*value, numInt + numDec + 1, numDec, cbuf);
-        valueStr = String(cbuf);
-        valueStr.replace(' ', '0');
+        hotplate.updatePidGains();
     }
+}
+
+#define PID_CONSTANT_NUM_INT 4
+#define PID_CONSTANT_NUM_DEC 1
 
-    // Loop over als string chars
-    for (uint8_t i = 0; i < valueStr.length(); i++)
+void Ui::changeMode(Mode nextMode)
+{
+    _setup.screen = SetupScreen::Menu;
+    _setup.cursor = 0;
+    _setup.dirty = true;
+    _mainScreenDirty = UI_MAIN_TILES_ALL; // Force redraw of main screen
+    _mode = nextMode;
+}
+
+/**
+ * @brief Queue an user input for the next loop(). Safe to be called from ISR.
+ */
+void Ui::input(Input in)
+{
+    switch (in)
     {
-        if (valueStr[i] == '.')
-            continue;
+    case Input::Plus:
+        if (_pendingSteps < INT8_MAX)
+            _pendingSteps++;
+        break;
+    case Input::Minus:
+        if (_pendingSteps > INT8_MIN)
+            _pendingSteps--;
+        break;
+    case Input::Push:
+        _pendingPush = true;
+        break;
+    case Input::LongPush:
+        _pendingLongPush = true;
+        break;
+    }
+}
 
-        prePart = pre;
-        prePart += valueStr.substring(0, i);
-        prePart += "[";
+/**
+ * @brief Queue a mode change for the next loop(). Safe to be called from ISR.
+ */
+void Ui::requestMode(Mode nextMode)
+{
+    _pendingMode = nextMode;
+}
 
-        iV = valueStr[i] & 0x0f;
+/**
+ * @brief Convert a positive value into zero padded fixed-point digits (_setup.digits), without heap or dtostrf() usage
+ */
+void Ui::valueToDigits(double value, uint8_t numInt, uint8_t numDec)
+{
+    uint8_t numDigits = min(numInt + numDec, UI_INPUT_MAX_DIGITS);
+    uint8_t dotPos = numDigits - min(numDec, numDigits);
+    uint8_t len = numDigits + (numDec ? 1 : 0);
+    uint32_t scale = 1, fixed;
 
-        postPart = "]";
-        postPart += valueStr.substring(i + 1);
+    for (uint8_t i = 0; i < numDec; i++)
+        scale *= 10;
 
-        if (u8g2.userInterfaceInputValue(title, prePart.c_str(), &iV, 0, 9, 1, postPart.c_str()) == 0)
-            return; // We don't have a "home" (escape) button yet
-        valueStr[i] = iV + 0x30;
+    fixed = (value > 0) ? (uint32_t)(value * scale + 0.5) : 0;
+    _setup.digits[len] = '\0';
+    for (uint8_t i = len; i-- > 0;)
+    {
+        if (numDec && i == dotPos)
+        {
+            _setup.digits[i] = '.';
+            continue;
+        }
+        _setup.digits[i] = '0' + fixed % 10;
+        fixed /= 10;
     }
-    *value = valueStr.toDouble();
 }
 
-void Ui::inputBangValues()
+/**
+ * @brief Parse _setup.digits back to fixed-point. The double conversion happens only once at the end
+ */
+double Ui::digitsToValue()
 {
-    u8g2.firstPage();
-    do
+    uint32_t fixed = 0, scale = 1;
+    bool dec = false;
+
+    for (const char *c = _setup.digits; *c; c++)
     {
-        setStdFont();
-        if (u8g2.userInterfaceInputValue("Bang-ON until\ntarget-temp", "minus ", &Config::active.pid_bangOn_temp_c, 0, 255, 3, " °C") == 0)
-            return; // We don't have a "home" (escape) button
-        if (u8g2.userInterfaceInputValue("Bang-OFF at\ntarget-temp", "plus ", &Config::active.pid_bangOff_temp_c, 0, 255, 3, " °C") == 0)
-            return; // We don't have a "home" (escape) button
-    } while (u8g2.nextPage());
+        if (*c == '.')
+        {
+            dec = true;
+            continue;
+        }
+        fixed = fixed * 10 + (*c - '0');
+        if (dec)
+            scale *= 10;
+    }
+    return (double)fixed / scale;
 }
 
-void Ui::inputMaxTemp()
+/**
+ * @brief Switch to a setup screen and init the widget state with the current config value
+ */
+void Ui::enterSetupScreen(SetupScreen screen)
 {
-    u8g2.firstPage();
-    do
+    _setup.screen = screen;
+    _setup.cursor = 0;
+    _setup.dirty = true;
+
+    switch (screen)
     {
-        setStdFont();
-        if (u8g2.userInterfaceInputValue("Set max.", "Temperature ", &Config::active.max_temp_c, 0, 255, 3, " °C") == 0)
-            return; // We don't have a "home" (escape) button yet
-    } while (u8g2.nextPage());
+    case SetupScreen::Profile:
+        _setup.cursor = Config::active.profile;
+        break;
+    case SetupScreen::ProfileStart:
+        _setup.cursor = Config::active.profile_warm_start ? 1 : 0;
+        break;
+    case SetupScreen::StandbyHold:
+        _setup.cursor = static_cast<uint8_t>(Config::active.standby_hold);
+        break;
+    case SetupScreen::StandbyTemp:
+        _setup.value = Config::active.standby_temp_c;
+        break;
+    case SetupScreen::SsrType:
+        _setup.cursor = Config::active.ssr_active_low ? 0 : 1;
+        break;
+    case SetupScreen::HeaterPower:
+        _setup.value = Config::active.heater_10w;
+        break;
+    case SetupScreen::MaxTemp:
+        _setup.value = Config::active.max_temp_c;
+        break;
+    case SetupScreen::SlewRate:
+        _setup.value = Config::active.setpoint_slew_cs;
+        break;
+    case SetupScreen::BangOn:
+        _setup.value = Config::active.pid_bangOn_temp_c;
+        break;
+    case SetupScreen::BangOff:
+        _setup.value = Config::active.pid_bangOff_temp_c;
+        break;
+    case SetupScreen::BatchRuns:
+        _setup.value = Config::active.batch_runs;
+        break;
+    case SetupScreen::BatchReady:
+        _setup.value = Config::active.batch_ready_temp_c;
+        break;
+    case SetupScreen::PidKp:
+        valueToDigits(Config::active.pid_Kp, PID_CONSTANT_NUM_INT, PID_CONSTANT_NUM_DEC);
+        break;
+    case SetupScreen::PidKi:
+        valueToDigits(Config::active.pid_Ki, PID_CONSTANT_NUM_INT, PID_CONSTANT_NUM_DEC);
+        break;
+    case SetupScreen::PidKd:
+        valueToDigits(Config::active.pid_Kd, PID_CONSTANT_NUM_INT, PID_CONSTANT_NUM_DEC);
+        break;
+    case SetupScreen::Memory:
+        Memory::printReport();
+        break;
+#if HOTPLATE_CHANNELS > 1
+    case SetupScreen::Channel:
+        _setup.cursor = _channel;
+        break;
+#endif
+    default:
+        break;
+    }
 }
 
-void Ui::inputPidConstants()
+void Ui::selectSetupMenu(uint8_t entry)
 {
-    u8g2.firstPage();
-    do
+    switch (entry)
     {
-        setStdFont();
-        const char *title = "Select\nPID constant";
-        userInterfaceInputDouble(title, "Kp = ", &Config::active.pid_Kp, 4, 1, "");
-        userInterfaceInputDouble(title, "Ki = ", &Config::active.pid_Ki, 4, 1, "");
-        userInterfaceInputDouble(title, "Kd = ", &Config::active.pid_Kd, 4, 1, "");
-    } while (u8g2.nextPage());
+    case ReflowProfile:
+        enterSetupScreen(SetupScreen::Profile);
+        break;
+    case ProfileStart:
+        enterSetupScreen(SetupScreen::ProfileStart);
+        break;
+    case StandbyHold:
+        enterSetupScreen(SetupScreen::StandbyHold);
+        break;
+    case SsrType:
+        enterSetupScreen(SetupScreen::SsrType);
+        break;
+    case HeaterPower:
+        enterSetupScreen(SetupScreen::HeaterPower);
+        break;
+    case MaxTemp:
+        enterSetupScreen(SetupScreen::MaxTemp);
+        break;
+    case SlewRate:
+        enterSetupScreen(SetupScreen::SlewRate);
+        break;
+    case PidConstants:
+        enterSetupScreen(SetupScreen::PidKp);
+        break;
+    case BangBang:
+        enterSetupScreen(SetupScreen::BangOn);
+        break;
+    case Batch:
+        enterSetupScreen(SetupScreen::BatchRuns);
+        break;
+    case PidTuner:
+        hotplates[_channel].dispatch(Hotplate::Event::Tune);
+        changeMode(Mode::Main);
+        break;
+    case MemoryInfo:
+        enterSetupScreen(SetupScreen::Memory);
+        break;
+    case LastRun:
+        changeMode(Mode::Summary);
+        break;
+#ifdef LIVE_GRAPH
+    case RunGraph:
+        changeMode(Mode::Graph);
+        break;
+#endif
+#if HOTPLATE_CHANNELS > 1
+    case Channel:
+        enterSetupScreen(SetupScreen::Channel);
+        break;
+#endif
+    case LoadSaved:
+        Config::load();
+        updatePidGains();
+        break;
+    case SaveQuit:
+        Config::save();
+        changeMode(Mode::Main);
+        break;
+    case Quit:
+        changeMode(Mode::Main);
+        break;
+    default: // Not implemented yet
+        break;
+    }
+}
+
+/**
+ * @brief Setup state machine. Consumes the queued encoder inputs of one loop() tick and never blocks
+ *
+ * @param steps Plus (> 0) or Minus (< 0) steps since the last call
+ * @param push true if the knob got pushed since the last call
+ */
+void Ui::handleSetupInput(int8_t steps, bool push)
+{
+    uint8_t numEntries = 0;
+
+    if (!steps && !push)
+    {
+        return;
+    }
+    _setup.dirty = true;
+
+    switch (_setup.screen)
+    {
+    // ----- List widgets -----
+    case SetupScreen::Menu:
+        numEntries = sizeof(setupMenuEntries) / sizeof(setupMenuEntries[0]);
+        break;
+    case SetupScreen::Profile:
+        numEntries = sizeof(Profile::profileNames) / sizeof(Profile::profileNames[0]);
+        break;
+    case SetupScreen::ProfileStart:
+        numEntries = sizeof(profileStartEntries) / sizeof(profileStartEntries[0]);
+        break;
+    case SetupScreen::StandbyHold:
+        numEntries = sizeof(standbyHoldEntries) / sizeof(standbyHoldEntries[0]);
+        break;
+    case SetupScreen::SsrType:
+        numEntries = sizeof(ssrTypeEntries) / sizeof(ssrTypeEntries[0]);
+        break;
+#if HOTPLATE_CHANNELS > 1
+    case SetupScreen::Channel:
+        numEntries = HOTPLATE_CHANNELS;
+        break;
+#endif
+
+    // ----- Value widgets -----
+    case SetupScreen::HeaterPower:
+    case SetupScreen::MaxTemp:
+    case SetupScreen::SlewRate:
+    case SetupScreen::BangOn:
+    case SetupScreen::BangOff:
+    case SetupScreen::BatchRuns:
+    case SetupScreen::BatchReady:
+    case SetupScreen::StandbyTemp:
+        _setup.value = constrain(_setup.value + steps, 0, UINT8_MAX);
+        if (!push)
+            return;
+        if (_setup.screen == SetupScreen::MaxTemp)
+        {
+            Config::active.max_temp_c = _setup.value;
+            enterSetupScreen(SetupScreen::Menu);
+        }
+        else if (_setup.screen == SetupScreen::HeaterPower)
+        {
+            Config::active.heater_10w = _setup.value;
+            enterSetupScreen(SetupScreen::Menu);
+        }
+        else if (_setup.screen == SetupScreen::SlewRate)
+        {
+            Config::active.setpoint_slew_cs = _setup.value;
+            enterSetupScreen(SetupScreen::Menu);
+        }
+        else if (_setup.screen == SetupScreen::BangOn)
+        {
+            Config::active.pid_bangOn_temp_c = _setup.value;
+            enterSetupScreen(SetupScreen::BangOff);
+        }
+        else if (_setup.screen == SetupScreen::BatchRuns)
+        {
+            Config::active.batch_runs = _setup.value;
+            enterSetupScreen(SetupScreen::BatchReady);
+        }
+        else if (_setup.screen == SetupScreen::BatchReady)
+        {
+            Config::active.batch_ready_temp_c = _setup.value;
+            enterSetupScreen(SetupScreen::Menu);
+        }
+        else if (_setup.screen == SetupScreen::StandbyTemp)
+        {
+            Config::active.standby_temp_c = _setup.value;
+            enterSetupScreen(SetupScreen::Menu);
+        }
+        else
+        {
+            Config::active.pid_bangOff_temp_c = _setup.value;
+            updatePidGains();
+            enterSetupScreen(SetupScreen::Menu);
+        }
+        return;
+
+    // ----- Digit widgets -----
+    case SetupScreen::PidKp:
+    case SetupScreen::PidKi:
+    case SetupScreen::PidKd:
+    {
+        char *digit = &_setup.digits[_setup.cursor];
+        *digit = '0' + ((*digit - '0' + steps % 10 + 10) % 10);
+        if (!push)
+            return;
+        if (_setup.digits[++_setup.cursor] == '.')
+            _setup.cursor++;
+        if (_setup.digits[_setup.cursor]) // More digits to edit
+            return;
+
+        if (_setup.screen == SetupScreen::PidKp)
+        {
+            Config::active.pid_Kp = digitsToValue();
+            enterSetupScreen(SetupScreen::PidKi);
+        }
+        else if (_setup.screen == SetupScreen::PidKi)
+        {
+            Config::active.pid_Ki = digitsToValue();
+            enterSetupScreen(SetupScreen::PidKd);
+        }
+        else
+        {
+            Config::active.pid_Kd = digitsToValue();
+            updatePidGains();
+            enterSetupScreen(SetupScreen::Menu);
+        }
+        return;
+    }
+
+    // ----- Message widgets -----
+    case SetupScreen::Memory:
+        if (push)
+            enterSetupScreen(SetupScreen::Menu);
+        return;
+    }
+
+    // List widget handling
+    _setup.cursor = (_setup.cursor + numEntries + steps % numEntries) % numEntries;
+    if (!push)
+        return;
+
+    switch (_setup.screen)
+    {
+    case SetupScreen::Menu:
+        selectSetupMenu(_setup.cursor);
+        break;
+    case SetupScreen::Profile:
+        Config::active.profile = static_cast<Profile::Profiles>(_setup.cursor);
+        enterSetupScreen(SetupScreen::Menu);
+        break;
+    case SetupScreen::ProfileStart:
+        Config::active.profile_warm_start = (_setup.cursor == 1);
+        enterSetupScreen(SetupScreen::Menu);
+        break;
+    case SetupScreen::StandbyHold:
+        Config::active.standby_hold = static_cast<Profile::Hold>(_setup.cursor);
+        enterSetupScreen(Config::active.standby_hold == Profile::Hold::Custom ? SetupScreen::StandbyTemp : SetupScreen::Menu);
+        break;
+    case SetupScreen::SsrType:
+        Config::active.ssr_active_low = (_setup.cursor == 0);
+        enterSetupScreen(SetupScreen::Menu);
+        break;
+#if HOTPLATE_CHANNELS > 1
+    case SetupScreen::Channel:
+        _channel = _setup.cursor;
+        changeMode(Mode::Main);
+        break;
+#endif
+    default:
+        break;
+    }
 }
 
 void Ui::setStdFont()
@@ -246,95 +677,410 @@ void Ui::setStdFont()
     u8g2.setFont(my_u8g2_font_7x13B);
 }
 
-void Ui::inputSsrType()
+/**
+ * @brief Draw UTF8 string s, with '\n' as line separator
+ *
+ * @return Height of all drawn lines
+ */
+u8g2_uint_t Ui::drawUTF8Lines(u8g2_uint_t x, u8g2_uint_t y, u8g2_uint_t w, u8g2_uint_t line_height, const char *s)
 {
+    char line[(128 / 7) + 1]; // Max. chars per display line (std font) + '\0'
+    u8g2_uint_t h = 0;
+    uint8_t len;
+
+    while (*s)
+    {
+        for (len = 0; s[len] && s[len] != '\n' && len < sizeof(line) - 1; len++)
+            line[len] = s[len];
+        line[len] = '\0';
+        s += len;
+        if (*s == '\n')
+            s++;
+
+        h += line_height;
+        u8g2.drawUTF8(x + (w - u8g2.getUTF8Width(line)) / 2, y + h, line);
+    }
+    return h;
+}
+
+/**
+ * @brief Draw a (scrolling) selection list with the entry at _setup.cursor highlighted
+ */
+void Ui::drawSelectionList(const char *title, const char *entries, uint8_t entrySize, uint8_t numEntries)
+{
+    char text[UI_TITLE_SIZE]; // Title, then the entries
+    uint8_t top = (_setup.cursor >= UI_LIST_ROWS) ? _setup.cursor - (UI_LIST_ROWS - 1) : 0;
+    u8g2_uint_t y = UI_LINE_HEIGHT - 3;
+
+    strcpy_P(text, title);
+    u8g2.drawUTF8((u8g2.getDisplayWidth() - u8g2.getUTF8Width(text)) / 2, y, text);
+    u8g2.drawHLine(0, y + 2, u8g2.getDisplayWidth());
+
+    u8g2.setFontMode(0);
+    for (uint8_t i = top; i < numEntries && i < top + UI_LIST_ROWS; i++)
+    {
+        y += UI_LINE_HEIGHT + 1;
+        if (i == _setup.cursor)
+        {
+            u8g2.setDrawColor(1);
+            u8g2.drawBox(0, y - UI_LINE_HEIGHT + 3, u8g2.getDisplayWidth(), UI_LINE_HEIGHT);
+            u8g2.setDrawColor(0);
+        }
+        memcpy_P(text, entries + i * entrySize, entrySize);
+        u8g2.drawUTF8(2, y, text);
+        u8g2.setDrawColor(1);
+    }
+}
+
+void Ui::drawInputValue(const char *title, const char *pre, const char *post)
+{
+    char line[UI_TITLE_SIZE]; // Title, then pre + "123" + post + '\0'
+    strcpy_P(line, title);
+    u8g2_uint_t y = drawUTF8Lines(0, 0, u8g2.getDisplayWidth(), UI_LINE_HEIGHT, line) + UI_LINE_HEIGHT + 4;
+
+    strcpy_P(line, pre);
+    appendNumber(line, _setup.value, 3);
+    strcat_P(line, post);
+    u8g2_uint_t x = (u8g2.getDisplayWidth() - u8g2.getUTF8Width(line)) / 2;
+    u8g2.drawUTF8(x, y, line);
+
+    // Frame around the value
+    line[strlen_P(pre)] = '\0';
+    x += u8g2.getUTF8Width(line);
+    u8g2.drawFrame(x - 2, y - UI_LINE_HEIGHT + 1, 3 * 7 + 4, UI_LINE_HEIGHT + 2);
+}
+
+void Ui::drawInputDigits(const char *title, const char *pre)
+{
+    char line[UI_TITLE_SIZE]; // Title, then pre + digits + '\0'
+    strcpy_P(line, title);
+    u8g2_uint_t y = drawUTF8Lines(0, 0, u8g2.getDisplayWidth(), UI_LINE_HEIGHT, line) + UI_LINE_HEIGHT + 4;
+
+    strcpy_P(line, pre);
+    strcat(line, _setup.digits);
+    u8g2_uint_t x = (u8g2.getDisplayWidth() - u8g2.getUTF8Width(line)) / 2;
+    u8g2.drawUTF8(x, y, line);
+
+    // Frame around the edited digit
+    line[strlen_P(pre) + _setup.cursor] = '\0';
+    x += u8g2.getUTF8Width(line);
+    u8g2.drawFrame(x - 1, y - UI_LINE_HEIGHT + 1, 7 + 2, UI_LINE_HEIGHT + 2);
+}
+
+void Ui::drawMemoryInfo()
+{
+    char line[20]; // Longest entry = "Unused: 1234 byte\0"
+    u8g2_uint_t y = UI_LINE_HEIGHT - 3;
+
+    u8g2.drawStr(0, y, "Memory (peak)");
+    u8g2.drawHLine(0, y + 2, u8g2.getDisplayWidth());
+
+    y += UI_LINE_HEIGHT + 1;
+    strcpy_P(line, PSTR("Stack: "));
+    appendNumber(line, Memory::getStackPeak(), 4);
+    strcat_P(line, PSTR(" byte"));
+    u8g2.drawStr(0, y, line);
+
+    y += UI_LINE_HEIGHT + 1;
+    strcpy_P(line, PSTR("Heap: "));
+    appendNumber(line, Memory::getHeapPeak(), 4);
+    strcat_P(line, PSTR(" byte"));
+    u8g2.drawStr(0, y, line);
+
+    y += UI_LINE_HEIGHT + 1;
+    strcpy_P(line, PSTR("Unused: "));
+    appendNumber(line, Memory::getUnusedRam(), 4);
+    strcat_P(line, PSTR(" byte"));
+    u8g2.drawStr(0, y, line);
+}
+
+void Ui::displaySetupScreen()
+{
+    if (!_setup.dirty)
+    {
+        return;
+    }
+    _setup.dirty = false;
+
     u8g2.firstPage();
     do
     {
         setStdFont();
-        uint8_t sel = u8g2.userInterfaceSelectionList("Setup SSR Type", (Config::active.ssr_active_low ? 1 : 2), "Active Low\nActive High");
-        switch (sel)
+        switch (_setup.screen)
         {
-        case 1: // Active Low
-            Config::active.ssr_active_low = true;
+        case SetupScreen::Menu:
+            drawSelectionList(PSTR("Setup (" VERSION_TEXT ")"), UI_LIST(setupMenuEntries));
+            break;
+        case SetupScreen::Profile:
+            drawSelectionList(PSTR("Setup Profile"), UI_LIST(Profile::profileNames));
+            break;
+        case SetupScreen::ProfileStart:
+            drawSelectionList(PSTR("Profile start"), UI_LIST(profileStartEntries));
+            break;
+        case SetupScreen::StandbyHold:
+            drawSelectionList(PSTR("Standby hold"), UI_LIST(standbyHoldEntries));
+            break;
+        case SetupScreen::StandbyTemp:
+            drawInputValue(PSTR("Standby hold\ntemperature"), PSTR(""), PSTR(" °C"));
+            break;
+        case SetupScreen::SsrType:
+            drawSelectionList(PSTR("Setup SSR Type"), UI_LIST(ssrTypeEntries));
+            break;
+        case SetupScreen::HeaterPower:
+            drawInputValue(PSTR("Heater power\n(energy meter)"), PSTR(""), PSTR("0 W")); // 10 W units
             break;
-        case 2: // Active High
-            Config::active.ssr_active_low = false;
+        case SetupScreen::MaxTemp:
+            drawInputValue(PSTR("Set max."), PSTR("Temperature "), PSTR(" °C"));
             break;
+        case SetupScreen::SlewRate:
+            drawInputValue(PSTR("Setpoint slew\n(0 = off)"), PSTR(""), PSTR(" °C/s"));
+            break;
+        case SetupScreen::BangOn:
+            drawInputValue(PSTR("Bang-ON until\ntarget-temp"), PSTR("minus "), PSTR(" °C"));
+            break;
+        case SetupScreen::BangOff:
+            drawInputValue(PSTR("Bang-OFF at\ntarget-temp"), PSTR("plus "), PSTR(" °C"));
+            break;
+        case SetupScreen::BatchRuns:
+            drawInputValue(PSTR("Batch: Profile\nruns (1 = off)"), PSTR(""), PSTR(" runs"));
+            break;
+        case SetupScreen::BatchReady:
+            drawInputValue(PSTR("Batch: Ready if\ncooled below"), PSTR(""), PSTR(" °C"));
+            break;
+        case SetupScreen::PidKp:
+            drawInputDigits(PSTR("Select\nPID constant"), PSTR("Kp = "));
+            break;
+        case SetupScreen::PidKi:
+            drawInputDigits(PSTR("Select\nPID constant"), PSTR("Ki = "));
+            break;
+        case SetupScreen::PidKd:
+            drawInputDigits(PSTR("Select\nPID constant"), PSTR("Kd = "));
+            break;
+        case SetupScreen::Memory:
+            drawMemoryInfo();
+            break;
+#if HOTPLATE_CHANNELS > 1
+        case SetupScreen::Channel:
+            drawSelectionList(PSTR("Setup Channel"), channelEntries[0], sizeof(channelEntries[0]), HOTPLATE_CHANNELS);
+            break;
+#endif
         }
     } while (u8g2.nextPage());
 }
 
-void Ui::inputReflowProfile()
+/**
+ * @brief Post-run summary with the run metrics of the last profile run.
+ * Two pages (_setup.cursor): Control quality, and energy/SSR duty per segment
+ */
+void Ui::displaySummaryScreen()
 {
+    if (!_setup.dirty)
+    {
+        return;
+    }
+    _setup.dirty = false;
+
+    const Profile::RunMetrics &m = profile.getRunMetrics();
+    char line[20]; // Longest entry = "Ramp: 12.3°C/s\0"
+    u8g2_uint_t y;
+
     u8g2.firstPage();
     do
     {
         setStdFont();
-        String modeList = "";
+        y = UI_LINE_HEIGHT - 3;
+        if (!profile.hasRunMetrics())
+        {
+            u8g2.drawStr(0, y, "No run yet");
+            continue;
+        }
 
-        for (uint8_t i = 0; i < sizeof(Profile::profile2str) / sizeof(char *); ++i)
+        if (_setup.cursor)
         {
-            if (i > 0)
-                modeList += "\n";
-            modeList += profile.profile2str[i];
+            line[0] = '\0';
+            appendNumber(line, m.energy_dWh, 0, true);
+            strcat_P(line, PSTR("Wh"));
+            u8g2.drawStr(0, y, line);
+            strcpy_P(line, PSTR("SSR "));
+            appendNumber(line, m.switches);
+            u8g2.drawStr(u8g2.getDisplayWidth() - u8g2.getStrWidth(line), y, line);
+            u8g2.drawHLine(0, y + 2, u8g2.getDisplayWidth());
+
+            y += UI_LINE_HEIGHT + 1;
+            u8g2.drawStr(0, y, "Duty/segment %");
+            y += UI_LINE_HEIGHT + 1;
+            for (uint8_t i = 0; i < PROFILE_SEGMENTS_MAX; i++)
+            {
+                if (m.segmentDuty[i] == PROFILE_DUTY_SKIPPED)
+                {
+                    continue;
+                }
+                u8g2.drawStr(i * (u8g2.getDisplayWidth() / PROFILE_SEGMENTS_MAX), y,
+                             formatNumber(line, sizeof(line), m.segmentDuty[i]));
+            }
+
+            y += UI_LINE_HEIGHT + 1;
+            strcpy_P(line, PSTR("SSR life "));
+            appendNumber(line, runLog.getLifetimeSwitches(0));
+            u8g2.drawStr(0, y, line);
+            continue;
         }
 
-        uint8_t sel = u8g2.userInterfaceSelectionList("Setup Profile", Config::active.profile + 1, modeList.c_str());
-        Config::active.profile = static_cast<Profile::Profiles>(sel - 1);
+        strcpy_P(line, PSTR("Run "));
+        appendNumber(line, m.duration_s);
+        strcat(line, "s");
+        u8g2.drawStr(0, y, line);
+        strcpy_P(line, PSTR("TAL "));
+        appendNumber(line, m.aboveLiquidus_s);
+        strcat(line, "s");
+        u8g2.drawStr(u8g2.getDisplayWidth() - u8g2.getStrWidth(line), y, line);
+        u8g2.drawHLine(0, y + 2, u8g2.getDisplayWidth());
+
+        y += UI_LINE_HEIGHT + 1;
+        strcpy_P(line, PSTR("Peak: "));
+        appendNumber(line, m.peak_dc, 0, true);
+        strcat_P(line, PSTR("°C"));
+        u8g2.drawUTF8(0, y, line);
+
+        y += UI_LINE_HEIGHT + 1;
+        strcpy_P(line, PSTR("Ramp: "));
+        appendNumber(line, m.maxRamp_dcs, 0, true);
+        strcat_P(line, PSTR("°C/s"));
+        u8g2.drawUTF8(0, y, line);
+
+        y += UI_LINE_HEIGHT + 1;
+        strcpy_P(line, PSTR("Dev "));
+        appendNumber(line, (m.maxDeviation_dc + 5) / 10);
+        strcat_P(line, PSTR(" IAE "));
+        appendNumber(line, m.iae_dcs / 10);
+        u8g2.drawStr(0, y, line);
     } while (u8g2.nextPage());
 }
 
-void Ui::displaySetupScreen()
+#ifdef LIVE_GRAPH
+/**
+ * @brief Graph screen y of a temperature, clamped to the plot area
+ *
+ * @param scale Pixel per °C (fixed point 8.8)
+ */
+static u8g2_uint_t graphY(int16_t temp_c, uint16_t scale)
 {
+    int32_t height = ((int32_t)max(temp_c, (int16_t)0) * scale) >> 8;
+    return UI_GRAPH_TOP + UI_GRAPH_HEIGHT - 1 - min(height, (int32_t)UI_GRAPH_HEIGHT - 1);
+}
+
+/**
+ * @brief Plate temperature (solid) against the profile curve (dotted) of the (last) run, scaled 0..max_temp_c.
+ * Gets redrawn on a new sample only. Per page it costs one line per column and one division per curve vertex,
+ * independent of the run duration
+ */
+void Ui::displayGraphScreen()
+{
+    if (!_setup.dirty && graph.getRevision() == _graphRevision)
+    {
+        return;
+    }
+    _setup.dirty = false;
+    _graphRevision = graph.getRevision();
+
+    float temp = thermocouples[0].getTemperatureAverage(); // The profile (and the graph) follows the lead channel
+    uint16_t scale = ((uint32_t)UI_GRAPH_HEIGHT << 8) / Config::active.max_temp_c;
+    uint8_t shift = graph.getShift();
+    char line[12]; // Longest entry = "-123.4°C\0"
+    char elapsedBuf[8];
+
+    strcpy_P(line, PSTR("---"));
+    if (!isnan(temp))
+    {
+        line[0] = '\0';
+        appendNumber(line, (int16_t)lround(temp * 10), 0, true);
+    }
+    strcat_P(line, PSTR("°C"));
+    char *elapsed = formatNumber(elapsedBuf, sizeof(elapsedBuf) - 1, (uint32_t)graph.getSamples() * PROFILE_STEP_MS / 1000);
+    strcat(elapsed, "s");
+
     u8g2.firstPage();
     do
     {
         setStdFont();
-        String s = "Setup (";
-        s += VERSION_TEXT;
-        s += ")";
-
-        uint8_t sel = u8g2.userInterfaceSelectionList(s.c_str(), 1,
-                                                      "Reflow Profile\n(Display unit)\nSSR Type\nMax. Temperature\nPID constants\nBangBang\nPID Tuner\nLoad saved\nSave & Quit\nQuit");
-        //                                                    1               2              3         4                 5           6          7           8          9         10
-        switch (sel)
+        if (!graph.getSamples())
         {
-        case 1: // Reflow Profile
-            inputReflowProfile();
-            break;
-        case 3: // SSR Type
-            inputSsrType();
-            break;
-        case 4: // BangBang values
-            inputMaxTemp();
-            break;
-        case 5: // PID constants
-            inputPidConstants();
-            hotplate.updatePidGains();
-            break;
-        case 6: // BangBang values
-            inputBangValues();
-            break;
-        case 7: // PID Tuner
-            hotplate.setMode(Hotplate::Mode::PIDTuner);
-            changeMode(Mode::Main);
-            break;
-        case 8: // Load saved
-            Config::load();
-            break;
-        case 9: // Save & Quit
-            Config::save();
-            changeMode(Mode::Main);
-            break;
-        default:
-            changeMode(Mode::Main);
+            u8g2.drawStr(0, UI_LINE_HEIGHT - 3, "No run yet");
+            continue;
+        }
+        u8g2.drawUTF8(0, UI_LINE_HEIGHT - 3, line);
+        u8g2.drawStr(u8g2.getDisplayWidth() - u8g2.getStrWidth(elapsed), UI_LINE_HEIGHT - 3, elapsed);
+
+        // Plate temperature, each column connected to the previous one
+        u8g2_uint_t lastY = graphY(graph.getColumn(0), scale);
+        for (uint8_t x = 0; x < graph.getColumns(); x++)
+        {
+            u8g2_uint_t y = graphY(graph.getColumn(x), scale);
+            u8g2.drawVLine(x, min(y, lastY), max(y, lastY) - min(y, lastY) + 1);
+            lastY = y;
+        }
+
+        // Profile curve, a dot on every 2nd column along the vertex polyline
+        for (uint8_t i = 1; i < graph.getVertices(); i++)
+        {
+            int16_t x0 = graph.getVertex(i - 1).sample >> shift, x1 = graph.getVertex(i).sample >> shift;
+            int16_t y0 = graphY((graph.getVertex(i - 1).temp_dc + 5) / 10, scale);
+            int16_t y1 = graphY((graph.getVertex(i).temp_dc + 5) / 10, scale);
+            int16_t slope = x1 > x0 ? ((int32_t)(y1 - y0) << 8) / (x1 - x0) : 0; // Pixel per column (fixed point 8.8)
+
+            for (int16_t x = (x0 + 1) & ~1; x <= x1; x += 2)
+            {
+                u8g2.drawPixel(x, y0 + (((int32_t)slope * (x - x0)) >> 8));
+            }
         }
     } while (u8g2.nextPage());
 }
+#endif
 
 void Ui::loop()
 {
+    // Consume queued inputs every loop() tick, independent of the display refresh interval
+    int8_t steps;
+    bool push, longPush;
+    uint8_t nextMode;
+
+    noInterrupts();
+    steps = _pendingSteps;
+    _pendingSteps = 0;
+    push = _pendingPush;
+    _pendingPush = false;
+    longPush = _pendingLongPush;
+    _pendingLongPush = false;
+    nextMode = _pendingMode;
+    _pendingMode = UI_MODE_NONE;
+    interrupts();
+
+    if (nextMode != UI_MODE_NONE)
+    {
+        changeMode(static_cast<Mode>(nextMode));
+    }
+    else if (_mode == Mode::Main && longPush)
+    {
+        changeMode(Mode::Setup);
+    }
+    else if (_mode == Mode::Setup)
+    {
+        handleSetupInput(steps, push);
+    }
+    else if ((_mode == Mode::Summary || _mode == Mode::Graph) && push)
+    {
+        changeMode(Mode::Main); // Push dismisses the summary resp. graph
+    }
+    else if (_mode == Mode::Summary && steps)
+    {
+        _setup.cursor ^= 1; // Turn flips the page
+        _setup.dirty = true;
+    }
+    else if (_mode == Mode::Main && profile.consumeFinished())
+    {
+        changeMode(Mode::Summary); // Profile ran to the end
+    }
+
     uint32_t now = millis();
     if (now < _nextInterval_ms)
     {
@@ -347,7 +1093,15 @@ void Ui::loop()
     case Mode::Setup:
         displaySetupScreen();
         break;
+    case Mode::Summary:
+        displaySummaryScreen();
+        break;
+#ifdef LIVE_GRAPH
+    case Mode::Graph:
+        displayGraphScreen();
+        break;
+#endif
     default:
         displayMainScreen();
     }
-}
\ No newline at end of file
+}
@@ -32,12 +32,12 @@ namespace Config
                 uint32_t configChecksum = CRC32::calculate(&eConf.conf, 1);
 
 #ifdef DEBUG_SERIAL
-                Serial.print("EEPROM CRC: ");
+                Serial.print(F("EEPROM CRC: "));
                 Serial.print(eConf.crc, HEX);
-                Serial.print(", Conf CRC: ");
+                Serial.print(F(", Conf CRC: "));
                 Serial.print(configChecksum, HEX);
                 uint32_t defaultChecksum = CRC32::calculate(&active, 1);
-                Serial.print(", default Conf CRC: ");
+                Serial.print(F(", default Conf CRC: "));
                 Serial.println(defaultChecksum, HEX);
 #endif
 
@@ -55,7 +55,7 @@ namespace Config
                 eConf.conf = active;
 
 #ifdef DEBUG_SERIAL
-                Serial.print("New Conf CRC: ");
+                Serial.print(F("New Conf CRC: "));
                 Serial.println(eConf.crc, HEX);
 #endif
                 // No need to compare the config checksum if it changed, as we use put() which in turn use EEPROM.update() and write only on change
@@ -20,7 +20,7 @@
  *
  * Author: Jörg Ebeling <joerg@ebeling.ws>
  *
- * Usage:
+ * Usage (rows as printed by scripts/memory_report.py after each build):
  *     RAM      |    Flash    | Comment
  * ----------------------------------------------------------------------
  * 71.9%  1473    91.8% 28186   v0.3.0 new Bootloader
@@ -29,9 +29,14 @@
  * 80.2%  1643    91.1% 27992   v0.5.0
  */
 #include <Arduino.h>
+#include <avr/power.h>
+#include <avr/sleep.h>
 #include "main.hpp"
 #include "config.hpp"
+#include "FastGpio.hpp"
 #include "Led.hpp"
+#include "Memory.hpp"
+#include "Rotary.hpp"
 
 #if defined ATMEGA328_NEW_CH340_DBG || defined ATMEGA328_NEW_FTDI_DBG
 #undef DEBUG_SERIAL
@@ -43,35 +48,118 @@
 #endif
 
 // Init classes
-Led hotLed(LED_PIN);
-Thermocouple thermocouple(TC_CLK_PIN, TC_CS_PIN, TC_DO_PIN);
-Hotplate hotplate(SSR_Pin);
+Led<LED_PIN> hotLed;
+Thermocouple thermocouples[HOTPLATE_CHANNELS] = {
+    {TC_CS_PIN},
+#if HOTPLATE_CHANNELS > 1
+    {TC2_CS_PIN},
+#endif
+};
+Hotplate hotplates[HOTPLATE_CHANNELS] = {
+    {0},
+#if HOTPLATE_CHANNELS > 1
+    {1, HOTPLATE2_PROFILE_OFFSET_C},
+#endif
+};
 Profile profile;
+RunLog runLog;
+#ifdef CONTROL_TRACE
+ControlTrace controlTrace;
+#endif
+#ifdef LIVE_GRAPH
+Graph graph;
+#endif
+#ifdef FAN_PIN
+Fan<FAN_PIN> fan;
+#endif
 Ui ui;
 
 // Internal vars
-volatile byte rotary_aValPrev = 0;             // Rotary A, last level, see ISR(PCINT1_vect)
+Rotary rotary;                                 // Quadrature decoder, see ISR(PCINT1_vect)
 volatile byte rotary_sValPrev = 1;             // Rotary S, last level, see ISR(PCINT1_vect)
 volatile unsigned long rotary_sPressed_ms = 0; // volatile, see ISR(PCINT1_vect)
+volatile bool rotary_comboUsed = false;        // Turned while pushed, the release is no push, see ISR(PCINT1_vect)
+volatile int16_t knob_steps = 0;               // Main screen setpoint steps, queued by ISR(PCINT1_vect) for loop()
+volatile bool knob_push = false;               // Main screen push (start/stop), queued by ISR(PCINT1_vect) for loop()
+
+void handleKnobInputs();
+
+/**
+ * @brief Single char serial commands:
+ *   L = Print run log
+ *   F = Freeze control trace
+ *   T = Binary dump of the control trace (see scripts/trace_decode.py)
+ */
+void handleSerialCommand()
+{
+  if (!Serial.available())
+  {
+    return;
+  }
+  switch (Serial.read())
+  {
+  case 'L':
+  case 'l':
+    runLog.print();
+    break;
+#ifdef CONTROL_TRACE
+  case 'F':
+  case 'f':
+    controlTrace.freeze(ControlTrace::Freeze::Command);
+    break;
+  case 'T':
+  case 't':
+    controlTrace.dump();
+    break;
+#endif
+  }
+}
+
+#ifdef IDLE_SLEEP
+/**
+ * @brief Idle sleep till the next interrupt. Idle keeps the clocks of Timer0, TWI and USART running, so we get woken
+ *   latest by the next millis() tick (Timer0 overflow, every 1.024 ms), by an encoder pin change (which gets handled
+ *   completely within ISR(PCINT1_vect), so without additional latency) or by a received serial char.
+ *   Control and SSR window timing thus stay at ms resolution, but the CPU no longer spins in between.
+ */
+void idleSleep()
+{
+  set_sleep_mode(SLEEP_MODE_IDLE);
+  noInterrupts();
+  if (Serial.available())
+  {
+    interrupts();
+    return;
+  }
+  sleep_enable();
+  interrupts(); // The instruction after sei gets executed before any pending interrupt, so there's no lost wake-up
+  sleep_cpu();
+  sleep_disable();
+}
+#endif
 
 void setup()
 {
 #ifndef DEBUG_AVRSTUB
   Serial.begin(115200); // TODO: -> Setup?
-  Serial.println("Init...");
+  Serial.println(F("Init..."));
 #endif
 #ifdef DEBUG_AVRSTUB
   debug_init();
 #endif
 
   Config::load();
+  runLog.setup();
   ui.setup();
-  hotplate.setup();
+  for (Hotplate &hotplate : hotplates)
+  {
+    hotplate.setup();
+  }
 
   // FIXME JE: Check/Test if the internal pull up would save the external soldered ones
-  pinMode(ROTARY_A_PIN, INPUT_PULLUP); // Arduino Analog input 0 (PCINT8), input and set pull up resistor:
-  pinMode(ROTARY_B_PIN, INPUT_PULLUP); // Arduino Analog input 1 (PCINT9) an input and set pull up resistor:
-  pinMode(ROTARY_S_PIN, INPUT_PULLUP); // Arduino Analog input 2 (PCINT10) an input and set pull up resistor:
+  FastPin<ROTARY_A_PIN>::inputPullup(); // Arduino Analog input 0 (PCINT8), input and set pull up resistor:
+  FastPin<ROTARY_B_PIN>::inputPullup(); // Arduino Analog input 1 (PCINT9) an input and set pull up resistor:
+  FastPin<ROTARY_S_PIN>::inputPullup(); // Arduino Analog input 2 (PCINT10) an input and set pull up resistor:
   // This is ATMEGA368 specific, see page 75 of long datasheet
   // PCICR: Pin Change Interrupt Control Register - enables interrupt vectors
   // Bit 2 = enable PC vector 2 (PCINT23..16)
@@ -82,20 +170,57 @@ void setup()
   PCMSK1 |= (1 << ROTARY_A_INT);
   PCMSK1 |= (1 << ROTARY_B_INT);
   PCMSK1 |= (1 << ROTARY_S_INT);
+  rotary.begin(FastPin<ROTARY_A_PIN>::read() << 1 | FastPin<ROTARY_B_PIN>::read());
 
   interrupts(); // Enable interrupts
 
+#ifdef IDLE_SLEEP
+  // Unused peripherals. The thermocouple bus is bit-banged, the SSR windows and the fan are soft PWM.
+  // Timer1/Timer2 stay powered down for good: analogWrite() (or tone()) on their OCx pins, e.g. SSR2_PIN (D3, OC2B)
+  // or a fan on D9/D10/D11, would silently do nothing. Drop the matching power_timerX_disable() when adding such output
+  ADCSRA &= ~_BV(ADEN);
+  power_adc_disable();
+  power_spi_disable();
+  power_timer1_disable();
+  power_timer2_disable();
+#endif
+
+#ifndef DEBUG_AVRSTUB
+  Memory::printReport();
+#endif
 #ifdef DEBUG_SERIAL
-  Serial.println("loop()...");
+  Serial.println(F("loop()..."));
 #endif
 }
 
 void loop()
 {
+  float maxTemp = 0;
+
+  handleKnobInputs();
   profile.loop();
-  hotplate.loop();
+  for (uint8_t i = 0; i < HOTPLATE_CHANNELS; i++)
+  {
+    hotplates[i].loop();
+    float temp = thermocouples[i].getTemperatureAverage();
+    if (temp > maxTemp)
+    {
+      maxTemp = temp;
+    }
+  }
+#ifdef FAN_PIN
+  fan.loop();
+#endif
   ui.loop();
-  hotLed.blinkByTemp(thermocouple.getTemperatureAverage());
+  hotLed.blinkByTemp(maxTemp);
+  runLog.loop();
+  Memory::update();
+#ifndef DEBUG_AVRSTUB
+  handleSerialCommand();
+#endif
+#ifdef IDLE_SLEEP
+  idleSleep();
+#endif
 }
 
 /**
@@ -106,9 +231,10 @@ void loop()
  */
 bool startIfStandByProcess()
 {
-  if (hotplate.isStandBy())
+  Hotplate &hotplate = hotplates[ui.getChannel()];
+
+  if (hotplate.dispatch(Hotplate::Event::Start)) // i.e. armed PID Tuner
   {
-    hotplate.setState(Hotplate::State::Start);
     return true;
   }
   if (profile.isStandBy())
@@ -118,38 +244,102 @@ bool startIfStandByProcess()
   return false;
 }
 
-void onPlusPressed()
+/**
+ * @brief Route an input to the Ui, if it's within a mode which consumes inputs by its own (Setup, Summary)
+ *
+ * @return true if the input got queued for the Ui
+ * @return false if the Ui is within main mode
+ */
+bool uiConsumesInput(Ui::Input in)
 {
-  if (hotplate.getSetpoint() < Config::active.max_temp_c)
+  if (ui.isMode(Ui::Mode::Main))
   {
-    startIfStandByProcess();
-    hotplate.setSetpoint(hotplate.getSetpoint() + 1);
+    return false;
   }
+  ui.input(in);
+  return true;
 }
 
-void onMinusPressed()
+/**
+ * @param steps Setpoint steps (> 1 if accelerated). The Ui gets a single input per detent
+ */
+void onPlusPressed(uint8_t steps)
 {
-  if (hotplate.getSetpoint())
+  if (uiConsumesInput(Ui::Input::Plus))
   {
-    startIfStandByProcess();
-    hotplate.setSetpoint(hotplate.getSetpoint() - 1);
+    return;
+  }
+  knob_steps += steps;
+}
+
+void onMinusPressed(uint8_t steps)
+{
+  if (uiConsumesInput(Ui::Input::Minus))
+  {
+    return;
   }
+  knob_steps -= steps;
 }
 
 void onPushPressed()
 {
-  if (!startIfStandByProcess())
+  if (uiConsumesInput(Ui::Input::Push))
+  {
+    return;
+  }
+  knob_push = true;
+}
+
+/**
+ * @brief Apply the main screen knob inputs, as queued by ISR(PCINT1_vect): Setpoint change and start/stop.
+ *   Runs within loop(), so that the state machines and their serial output never run in interrupt context.
+ */
+void handleKnobInputs()
+{
+  int16_t steps;
+  bool push;
+
+  noInterrupts();
+  steps = knob_steps;
+  knob_steps = 0;
+  push = knob_push;
+  knob_push = false;
+  interrupts();
+
+  Hotplate &hotplate = hotplates[ui.getChannel()];
+  if (steps > 0 && hotplate.getSetpoint() < Config::active.max_temp_c)
   {
-    hotplate.setMode(Hotplate::Mode::Manual);
-    hotplate.setState(Hotplate::State::StandBy);
-    profile.stopProfile();
-    hotplate.setSetpoint(0);
+    startIfStandByProcess();
+    hotplate.setSetpoint(min(hotplate.getSetpoint() + steps, Config::active.max_temp_c));
+  }
+  else if (steps < 0 && hotplate.getSetpoint())
+  {
+    startIfStandByProcess();
+    hotplate.setSetpoint(hotplate.getSetpoint() > -steps ? hotplate.getSetpoint() + steps : 0);
+  }
+
+  if (push && !startIfStandByProcess()) // Stop all channels
+  {
+    bool wasRunning = profile.stopProfile();
+    for (Hotplate &channel : hotplates)
+    {
+      channel.dispatch(Hotplate::Event::Stop); // Resets a fault as well
+    }
+    if (wasRunning)
+    {
+      ui.requestMode(Ui::Mode::Summary);
+    }
   }
 }
 
 void onPushLongPressed()
 {
-  ui.changeMode(Ui::Mode::Setup);
+  if (!ui.isMode(Ui::Mode::Main))
+  {
+    onPushPressed(); // Setup, Summary etc. don't distinguish long from short push
+    return;
+  }
+  ui.input(Ui::Input::LongPush);
 }
 
 ISR(PCINT1_vect)
@@ -158,6 +348,7 @@ ISR(PCINT1_vect)
   byte aValAct;
   byte bValAct;
   byte sValAct;
+  int8_t steps;
 
   pVal = ROTARY_PORT_CMD;               // Read relevenat port (8 bit)
   aValAct = pVal & (1 << ROTARY_A_INT); // Mask out all except ...
@@ -168,31 +359,46 @@ ISR(PCINT1_vect)
   sValAct = sValAct >> ROTARY_S_INT;
 
   // A/B state callbacks
-  if (rotary_aValPrev != aValAct && aValAct)
+  steps = rotary.update(aValAct << 1 | bValAct, millis());
+  if (steps)
   {
-    if (aValAct != bValAct) // CW
+    if (!sValAct) // Turned while pushed = "push & turn" combo
+    {
+      rotary_comboUsed = true;
+#ifdef CONTROL_TRACE
+      controlTrace.freeze(ControlTrace::Freeze::Button);
+#endif
+    }
+    else if (steps > 0) // CW
     {
-      onPlusPressed();
+      onPlusPressed(steps);
     }
     else // CCW
     {
-      onMinusPressed();
+      onMinusPressed(-steps);
     }
   }
-  rotary_aValPrev = aValAct;
 
-  // S state callbacks
+  // S state callbacks, acting on release, so a "push & turn" combo doesn't count as push (stop)
   if (rotary_sValPrev == 1 && !sValAct) // button is pressed
   {
     rotary_sPressed_ms = millis();
-    onPushPressed();
+    rotary_comboUsed = false;
   }
   else if (!rotary_sValPrev && sValAct && rotary_sPressed_ms) // button is released && was pressed before (init fuse)
   {
-    if ((millis() - rotary_sPressed_ms) > LONG_PRESS_TIME_MS)
+    if (rotary_comboUsed)
+    {
+      // Consumed by the combo
+    }
+    else if ((millis() - rotary_sPressed_ms) > LONG_PRESS_TIME_MS)
     {
       onPushLongPressed();
     }
+    else
+    {
+      onPushPressed();
+    }
   }
   rotary_sValPrev = sValAct;
 }
\ No newline at end of file
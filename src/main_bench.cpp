@@ -0,0 +1,208 @@
+/*
+ * This file is part of the Another-HotPlate-Firmware project (https://github.com/Apehaenger/Another-HotPlate-Firmware).
+ * Copyright (c) 2022 Jörg Ebeling
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+/*
+ * Cycle benchmark firmware (env:BENCH) of the firmware hot paths.
+ *
+ * Meant to be run within simavr via scripts/bench_simavr.py, which compares the results against a stored baseline.
+ * Timer1 runs at clk/1 and together with its overflow counter results in a 32 bit cycle counter.
+ * Each benchmark runs BENCH_RUNS times and the minimum (minus the measurement overhead) gets reported as:
+ *   BENCH <name> <cycles>
+ */
+#include <Arduino.h>
+#include <avr/sleep.h>
+#include "main.hpp"
+#include "config.hpp"
+#include "FastGpio.hpp"
+#include "Led.hpp"
+#include "CRC32.h"
+
+#define BENCH_RUNS 8
+
+// Same globals as main.cpp. The benchmarks run on the lead channel
+Thermocouple thermocouples[HOTPLATE_CHANNELS] = {
+    {TC_CS_PIN},
+#if HOTPLATE_CHANNELS > 1
+    {TC2_CS_PIN},
+#endif
+};
+Hotplate hotplates[HOTPLATE_CHANNELS] = {
+    {0},
+#if HOTPLATE_CHANNELS > 1
+    {1, HOTPLATE2_PROFILE_OFFSET_C},
+#endif
+};
+static Thermocouple &thermocouple = thermocouples[0];
+static Hotplate &hotplate = hotplates[0];
+Led<LED_PIN> hotLed;
+Profile profile;
+RunLog runLog;
+#ifdef CONTROL_TRACE
+ControlTrace controlTrace;
+#endif
+#ifdef LIVE_GRAPH
+Graph graph;
+#endif
+#ifdef FAN_PIN
+Fan<FAN_PIN> fan;
+#endif
+Ui ui;
+
+volatile uint16_t timer1Overflows = 0;
+
+ISR(TIMER1_OVF_vect)
+{
+  timer1Overflows++;
+}
+
+class Benchmark
+{
+public:
+  static void run();
+
+private:
+  typedef void (*BenchFn)();
+
+  static uint32_t _overhead;
+  static volatile uint32_t _sink; // Results, so that the benchmarked code doesn't get optimized away
+
+  static uint32_t cycles();
+  static uint32_t measure(BenchFn prepare, BenchFn fn);
+  static void report(const char *name, BenchFn prepare, BenchFn fn);
+};
+
+uint32_t Benchmark::_overhead = 0;
+volatile uint32_t Benchmark::_sink;
+
+/**
+ * @brief Current cycle count of Timer1 + overflows
+ */
+uint32_t Benchmark::cycles()
+{
+  uint8_t oldSREG = SREG;
+  noInterrupts();
+  uint16_t ovf = timer1Overflows;
+  uint16_t cnt = TCNT1;
+  if ((TIFR1 & _BV(TOV1)) && cnt < 0x8000) // Overflow happened but not yet serviced
+    ovf++;
+  SREG = oldSREG;
+  return ((uint32_t)ovf << 16) | cnt;
+}
+
+/**
+ * @brief Minimum cycles of BENCH_RUNS calls of fn(), each after a call of prepare()
+ */
+uint32_t Benchmark::measure(BenchFn prepare, BenchFn fn)
+{
+  uint32_t best = UINT32_MAX, start, took;
+
+  for (uint8_t i = 0; i < BENCH_RUNS; i++)
+  {
+    if (prepare)
+      prepare();
+    start = cycles();
+    fn();
+    took = cycles() - start;
+    if (took < best)
+      best = took;
+  }
+  return best > _overhead ? best - _overhead : 0;
+}
+
+void Benchmark::report(const char *name, BenchFn prepare, BenchFn fn)
+{
+  uint32_t c = measure(prepare, fn);
+  Serial.print("BENCH ");
+  Serial.print(name);
+  Serial.print(" ");
+  Serial.println(c);
+  Serial.flush();
+}
+
+void Benchmark::run()
+{
+  // Timer1 as free running cycle counter
+  TCCR1A = 0;
+  TCCR1B = _BV(CS10); // clk/1
+  TIMSK1 = _BV(TOIE1);
+
+  _overhead = measure(nullptr, []() {});
+
+  // Control tick, without the (slow) MAX6675 read
+  hotplate.setSetpoint(150);
+  report("Hotplate::loop", []()
+         {
+           hotplate._nextInterval_ms = 0;
+           thermocouple._nextRead_ms = UINT32_MAX;
+         },
+         []() { hotplate.loop(); });
+
+  // GPIO: Arduino API vs. compile time resolved pin (FastGpio.hpp)
+  report("digitalWrite(SSR_Pin)", nullptr, []() { digitalWrite(SSR_Pin, HIGH); });
+  report("FastPin<SSR_Pin>::write", nullptr, []() { FastPin<SSR_Pin>::write(HIGH); });
+  report("Hotplate::setPower", nullptr, []() { hotplate.setPower(false); });
+  report("Led::blinkByTemp", nullptr, []() { hotLed.blinkByTemp(LED_HOT_TEMP); });
+
+  // Sensor read incl. average filter
+  report("Thermocouple::readTemperature", []() { thermocouple._nextRead_ms = 0; },
+         []() { thermocouple.readTemperature(); });
+
+  // Profile segment interpreter step, within a running profile (ramp segment)
+  Config::active.profile = Profile::Profiles::Sn42Bi576Ag04;
+  report("Profile::runSegment", []()
+         {
+           profile._metrics.profile = Config::active.profile;
+           profile._profileStart_ms = profile._segmentStart_ms = millis();
+           profile._segment = 0;
+           profile._setpoint_dc = 300;
+         },
+         []() { profile.runSegment(millis()); });
+
+  // Config checksum, as on each EEPROM load/save
+  report("CRC32::calculate(Conf)", nullptr, []() { _sink = CRC32::calculate(&Config::active, 1); });
+
+  // Unchanged values (nothing to draw)
+  report("Ui::displayMainScreen(unchanged)", nullptr, []() { ui.displayMainScreen(); });
+
+  // Temperature tile rows only (incl. I2C transfer)
+  report("Ui::displayMainScreen(temp)", []() { ui._mainScreenDirty = UI_MAIN_TILES_TEMP; },
+         []() { ui.displayMainScreen(); });
+
+  // Complete redraw (incl. I2C transfer)
+  report("Ui::displayMainScreen", []() { ui._mainScreenDirty = UI_MAIN_TILES_ALL; },
+         []() { ui.displayMainScreen(); });
+
+  Serial.println("BENCH done");
+  Serial.flush();
+}
+
+void setup()
+{
+  Serial.begin(115200);
+  ui.setup();
+  hotplate.setup();
+
+  Benchmark::run();
+
+  // simavr quits gracefully on sleep with interrupts disabled
+  noInterrupts();
+  sleep_enable();
+  sleep_cpu();
+}
+
+void loop()
+{
+}
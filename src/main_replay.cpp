@@ -0,0 +1,491 @@
+/*
+ * This file is part of the Another-HotPlate-Firmware project (https://github.com/Apehaenger/Another-HotPlate-Firmware).
+ * Copyright (c) 2022 Jörg Ebeling
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+/*
+ * Host (native) trace replay harness (env:REPLAY) with control quality metrics.
+ *
+ * Feeds recorded thermocouple traces (the PID Tuner CSV "time, output, input", i.e. as collected
+ * within the "assets/PID Tuner" notes) through the unmodified Hotplate, Profile and Thermocouple code.
+ * Arduino/EEPROM/U8g2 get replaced by replay/shim/, the thermocouple converter by a pin level mock
+ * of the selected chip (replay/shim/ThermocoupleMock.h, i.e. build_flags -D TC_MAX31855).
+ *
+ * Modes:
+ *   Model (default): A first-order-plus-dead-time plant model gets identified from the trace and simulated in closed loop
+ *   --replay:        The recorded temperatures get fed open loop (i.e. to check SSR switching on real sensor noise)
+ *
+ * Usage:
+ *   pio run -e REPLAY
+ *   .pio/build/REPLAY/program [options] <trace.md|trace.csv>...
+ *
+ * Options:
+ *   --replay              Open loop replay of the recorded temperatures
+ *   --run <n>             Only the n-th run (``` block) of each trace file (default: all)
+ *   --profile <n>         Start reflow profile n (see Profile::Profiles)
+ *   --setpoint <C>        Manual setpoint (default 100, if no profile)
+ *   --start-temp <C>      Plate temp at start (model mode, default: trace ambient), i.e. for a warm start
+ *   --cold-start          Run the full profile, even on a warm plate (Config::profile_warm_start = false)
+ *   --duration <s>        Simulated time (default: until the profile ends, max. 900s, resp. trace length)
+ *   --kp/--ki/--kd <v>    PID gains (default: Config defaults)
+ *   --bang-on/--bang-off <C>, --window <ms>
+ *   --slew <C/s>          Setpoint slew rate limit (default 0 = unlimited)
+ *   --max-temp <C>        Config::max_temp_c (default: Config default). High temp. profiles need it raised
+ *   --fan <k>             Model a cooling fan (FAN_PIN): Heat loss factor k on top of the natural one at full air
+ *                         (default 0 = no fan fitted)
+ *   --liquidus <C>        Liquidus temp for "time above liquidus" (default: Of the profile, Sn42/Bi57.6/Ag0.4 if manual)
+ *   --band <C>            Settle band (default 5)
+ *
+ * Output: One JSON object per run (JSON Lines) on stdout. Profile runs add the firmware's energy (Config::heater_10w)
+ *         and avg. SSR duty per segment
+ */
+#include <new>
+#include <string>
+#include <vector>
+#include <Arduino.h> // After the STL, due to Arduino's min()/max() macros
+#include <EEPROM.h>
+#include <ThermocoupleMock.h>
+#include "main.hpp"
+#include "config.hpp"
+
+#define REPLAY_STEP_MS 10
+#define REPLAY_WARMUP_MS 5000 // Let the thermocouple average settle before starting the run
+
+namespace Shim
+{
+    uint32_t millis_ms = 0;
+    uint8_t pinLevel[SHIM_NUM_PINS];
+    uint32_t pinToggles[SHIM_NUM_PINS];
+    float tcTemp_c = 0;
+    void (*pinWriteHook)(uint8_t pin, uint8_t val) = nullptr;
+    uint8_t eeprom[SHIM_EEPROM_SIZE];
+}
+
+HardwareSerial Serial;
+EEPROMClass EEPROM;
+
+// Same globals as main.cpp (single channel)
+static_assert(HOTPLATE_CHANNELS == 1, "The replay simulates a single channel plate");
+Thermocouple thermocouples[HOTPLATE_CHANNELS] = {{TC_CS_PIN}};
+Hotplate hotplates[HOTPLATE_CHANNELS] = {{0}};
+static Thermocouple &thermocouple = thermocouples[0];
+static Hotplate &hotplate = hotplates[0];
+Profile profile;
+#ifdef CONTROL_TRACE
+ControlTrace controlTrace;
+#endif
+#ifdef LIVE_GRAPH
+Graph graph;
+#endif
+Fan<FAN_PIN> fan;
+
+static Shim::TcMock tcMock(TC_CLK_PIN, TC_CS_PIN, TC_DO_PIN, TC_DI_PIN);
+
+namespace Replay
+{
+    typedef struct
+    {
+        float time_s;
+        float output; // Normalized 0..1
+        float temp_c;
+    } Sample;
+
+    typedef std::vector<Sample> Trace;
+
+    typedef struct
+    {
+        float ambient_c;
+        float gain_c;  // Steady state temperature rise @ 100% output
+        float tau_s;   // Time constant
+        float deadTime_s;
+    } PlantModel;
+
+    typedef struct
+    {
+        bool replay = false;
+        int run = 0; // 0 = all
+        int profile = -1;
+        float setpoint_c = 100;
+        float duration_s = 0;
+        float startTemp_c = NAN;
+        bool coldStart = false;
+        float liquidus_c = NAN; // See --liquidus
+        float band_c = 5;
+        double kp = NAN, ki = NAN, kd = NAN;
+        int bangOn_c = -1, bangOff_c = -1, window_ms = -1;
+        int slew_cs = 0;
+        int maxTemp_c = -1;
+        float fan_k = 0;
+    } Options;
+
+    typedef struct
+    {
+        float peak_c = -1000;
+        float overshoot_c = 0; // Above the highest setpoint so far (the profile peak), not the falling cool down setpoint
+        float settlingTime_s = 0;
+        float iae_cs = 0;
+        float aboveLiquidus_s = 0;
+        uint32_t ssrSwitches = 0;
+        float maxCoolRate_cs = 0; // Over 5s, i.e. to check the (fan) cool down rate limit
+        float duration_s = 0; // Simulated run time (i.e. until the profile ended)
+    } Metrics;
+
+    /**
+     * @brief Parse all runs of a trace file. Lines of "time, output, input" are samples,
+     * a ``` fence (markdown) or a time step backwards starts a new run.
+     */
+    std::vector<Trace> loadTraces(const char *path)
+    {
+        std::vector<Trace> traces;
+        Trace trace;
+        char line[128];
+        float t, out, temp;
+
+        FILE *f = fopen(path, "r");
+        if (!f)
+        {
+            perror(path);
+            return traces;
+        }
+        while (fgets(line, sizeof(line), f))
+        {
+            bool isSample = sscanf(line, "%f , %f , %f", &t, &out, &temp) == 3;
+            if ((!isSample && !strncmp(line, "```", 3)) || (isSample && !trace.empty() && t < trace.back().time_s))
+            {
+                if (!trace.empty())
+                    traces.push_back(trace);
+                trace.clear();
+            }
+            if (isSample)
+                trace.push_back({t, out, temp});
+        }
+        if (!trace.empty())
+            traces.push_back(trace);
+        fclose(f);
+
+        // Normalize output to 0..1 (PID Tuner output might be SSR state, pwm window or PID output range)
+        for (Trace &tr : traces)
+        {
+            float maxOut = 0;
+            for (const Sample &s : tr)
+                maxOut = max(maxOut, s.output);
+            for (Sample &s : tr)
+                s.output = maxOut > 0 ? s.output / maxOut : 0;
+        }
+        return traces;
+    }
+
+    /**
+     * @brief Identify a first-order-plus-dead-time model from a step response trace.
+     * Dead time = first rise > 1 C after heating start, tau = exponential fit of the cool down after the peak,
+     * gain = max. heating slope * tau.
+     */
+    PlantModel identify(const Trace &tr)
+    {
+        PlantModel m = {tr.front().temp_c, 300, 300, 0};
+        size_t i, start = 0, peak = 0;
+
+        for (i = 0; i < tr.size() && tr[i].output <= 0; i++)
+            ;
+        start = i;
+        for (; i < tr.size() && tr[i].temp_c < m.ambient_c + 1; i++)
+            ;
+        if (i < tr.size())
+            m.deadTime_s = tr[i].time_s - tr[start].time_s;
+
+        // Max. heating slope, over approx. 5s to suppress sensor noise
+        float maxSlope = 0;
+        for (i = start; i < tr.size() && tr[i].output > 0; i++)
+        {
+            size_t j = i;
+            while (j < tr.size() && tr[j].time_s - tr[i].time_s < 5)
+                j++;
+            if (j < tr.size() && tr[j].time_s > tr[i].time_s)
+                maxSlope = max(maxSlope, (tr[j].temp_c - tr[i].temp_c) / (tr[j].time_s - tr[i].time_s));
+        }
+
+        // Peak after the heater got switched off, followed by the cool down
+        for (i = start; i < tr.size() && tr[i].output > 0; i++)
+            ;
+        for (peak = i; i < tr.size() && tr[i].output <= 0; i++)
+            if (tr[i].temp_c > tr[peak].temp_c)
+                peak = i;
+
+        // Least squares fit of ln(T - ambient) = a - t / tau
+        double sx = 0, sy = 0, sxx = 0, sxy = 0;
+        size_t n = 0;
+        for (i = peak; i < tr.size() && tr[i].output <= 0 && tr[i].temp_c - m.ambient_c > 2; i++, n++)
+        {
+            double x = tr[i].time_s, y = log(tr[i].temp_c - m.ambient_c);
+            sx += x;
+            sy += y;
+            sxx += x * x;
+            sxy += x * y;
+        }
+        double slope = (n > 2) ? (n * sxy - sx * sy) / (n * sxx - sx * sx) : 0;
+        if (slope < 0)
+            m.tau_s = -1 / slope;
+        if (maxSlope > 0)
+            m.gain_c = maxSlope * m.tau_s;
+        return m;
+    }
+
+    /**
+     * @brief Recorded temperature at time t (linear interpolation)
+     */
+    float traceTemp(const Trace &tr, float t)
+    {
+        t += tr.front().time_s;
+        if (t <= tr.front().time_s)
+            return tr.front().temp_c;
+        for (size_t i = 1; i < tr.size(); i++)
+        {
+            if (tr[i].time_s >= t)
+            {
+                float f = (t - tr[i - 1].time_s) / (tr[i].time_s - tr[i - 1].time_s);
+                return tr[i - 1].temp_c + f * (tr[i].temp_c - tr[i - 1].temp_c);
+            }
+        }
+        return tr.back().temp_c;
+    }
+
+    /**
+     * @brief Reset the firmware objects to their power-on state
+     */
+    void resetFirmware(const Options &opt)
+    {
+        Config::active = Config::Conf();
+        if (!isnan(opt.kp))
+            Config::active.pid_Kp = opt.kp;
+        if (!isnan(opt.ki))
+            Config::active.pid_Ki = opt.ki;
+        if (!isnan(opt.kd))
+            Config::active.pid_Kd = opt.kd;
+        if (opt.bangOn_c >= 0)
+            Config::active.pid_bangOn_temp_c = opt.bangOn_c;
+        if (opt.bangOff_c >= 0)
+            Config::active.pid_bangOff_temp_c = opt.bangOff_c;
+        if (opt.window_ms > 0)
+            Config::active.pid_pwm_window_ms = opt.window_ms;
+        if (opt.maxTemp_c >= 0)
+            Config::active.max_temp_c = opt.maxTemp_c;
+        Config::active.setpoint_slew_cs = opt.slew_cs;
+        Config::active.profile_warm_start = !opt.coldStart;
+        Config::active.profile = opt.profile > 0 ? static_cast<Profile::Profiles>(opt.profile) : Profile::Profiles::Manual;
+
+        Shim::millis_ms = 0;
+        memset(Shim::pinLevel, 0, sizeof(Shim::pinLevel));
+
+        thermocouple.~Thermocouple();
+        new (&thermocouple) Thermocouple(TC_CS_PIN);
+        hotplate.~Hotplate();
+        new (&hotplate) Hotplate(0);
+        profile.~Profile();
+        new (&profile) Profile();
+        fan.~Fan();
+        new (&fan) Fan<FAN_PIN>();
+
+        hotplate.setup();
+        memset(Shim::pinToggles, 0, sizeof(Shim::pinToggles));
+    }
+
+    Metrics simulate(const Trace &tr, const PlantModel &model, const Options &opt)
+    {
+        Metrics m;
+        std::vector<uint8_t> delayLine(max(1, (int)(model.deadTime_s * 1000 / REPLAY_STEP_MS)), 0);
+        size_t delayPos = 0;
+        float temp = opt.replay ? traceTemp(tr, 0) : (isnan(opt.startTemp_c) ? model.ambient_c : opt.startTemp_c);
+        float duration_s = opt.duration_s;
+        uint32_t runStart_ms;
+        std::vector<float> temps_s; // Plate temp, once per second
+        float liquidus_c = !isnan(opt.liquidus_c) ? opt.liquidus_c
+                           : Profile::getLiquidus(opt.profile > 0 ? static_cast<Profile::Profiles>(opt.profile)
+                                                                  : Profile::Profiles::Sn42Bi576Ag04);
+        float peakSetpoint = 0;
+
+        resetFirmware(opt);
+        if (!duration_s)
+            duration_s = opt.replay ? tr.back().time_s - tr.front().time_s
+                                    : (opt.profile > 0 ? 900 : 600);
+
+        // Warm up the thermocouple average
+        Shim::tcTemp_c = temp;
+        for (; Shim::millis_ms < REPLAY_WARMUP_MS; Shim::millis_ms += REPLAY_STEP_MS)
+        {
+            thermocouple.getTemperatureAverage();
+        }
+
+        runStart_ms = Shim::millis_ms;
+        if (opt.profile > 0)
+        {
+            if (!profile.startProfile())
+            {
+                fprintf(stderr, "Profile %d refused: Peak above max. temp %d, see --max-temp\n", opt.profile, Config::active.max_temp_c);
+                exit(1);
+            }
+        }
+        else
+            hotplate.setSetpoint(opt.setpoint_c);
+
+        for (; Shim::millis_ms - runStart_ms < duration_s * 1000; Shim::millis_ms += REPLAY_STEP_MS)
+        {
+            float t_s = (Shim::millis_ms - runStart_ms) / 1000.0;
+
+            profile.loop();
+            if (opt.profile > 0 && !opt.duration_s && !profile.isRunning())
+                break; // Profile ended (last segment done)
+            hotplate.loop();
+            fan.loop();
+
+            // Plant
+            if (opt.replay)
+            {
+                temp = traceTemp(tr, t_s);
+            }
+            else
+            {
+                delayLine[delayPos] = hotplate.getPower();
+                delayPos = (delayPos + 1) % delayLine.size();
+                float u = delayLine[delayPos]; // Oldest entry = dead time ago
+                float loss = 1 + opt.fan_k * Shim::pinLevel[FAN_PIN];
+                temp += REPLAY_STEP_MS / 1000.0 / model.tau_s * (model.gain_c * u - loss * (temp - model.ambient_c));
+            }
+            Shim::tcTemp_c = temp;
+
+            // Metrics
+            float setpoint = hotplate.getSetpoint();
+            m.peak_c = max(m.peak_c, temp);
+            if ((Shim::millis_ms - runStart_ms) % 1000 == 0)
+            {
+                temps_s.push_back(temp);
+                if (temps_s.size() > 5)
+                    m.maxCoolRate_cs = max(m.maxCoolRate_cs, (temps_s[temps_s.size() - 6] - temp) / 5);
+            }
+            if (temp > liquidus_c)
+                m.aboveLiquidus_s += REPLAY_STEP_MS / 1000.0;
+            if (setpoint > 0)
+            {
+                float err = temp - setpoint;
+                peakSetpoint = max(peakSetpoint, setpoint);
+                m.overshoot_c = max(m.overshoot_c, temp - peakSetpoint);
+                m.iae_cs += fabs(err) * REPLAY_STEP_MS / 1000.0;
+                if (fabs(err) > opt.band_c)
+                    m.settlingTime_s = t_s;
+            }
+        }
+        m.ssrSwitches = Shim::pinToggles[SSR_Pin];
+        profile.stopProfile(); // End of the simulated time: Like a user stop, finalizes the run metrics (if still running)
+        m.duration_s = (Shim::millis_ms - runStart_ms) / 1000.0;
+        return m;
+    }
+
+    void printJson(const char *path, int run, const PlantModel &model, const Metrics &m, const Options &opt)
+    {
+        printf("{\"trace\": \"%s\", \"run\": %d, \"mode\": \"%s\", ", path, run, opt.replay ? "replay" : "model");
+        printf("\"model\": {\"ambient_c\": %.2f, \"gain_c\": %.1f, \"tau_s\": %.1f, \"dead_time_s\": %.2f}, ",
+               model.ambient_c, model.gain_c, model.tau_s, model.deadTime_s);
+        printf("\"gains\": {\"kp\": %g, \"ki\": %g, \"kd\": %g}, ", Config::active.pid_Kp, Config::active.pid_Ki, Config::active.pid_Kd);
+        printf("\"profile\": %d, \"peak_c\": %.2f, \"overshoot_c\": %.2f, \"settling_time_s\": %.2f, ",
+               opt.profile > 0 ? opt.profile : 0, m.peak_c, m.overshoot_c, m.settlingTime_s);
+        printf("\"iae_cs\": %.1f, \"time_above_liquidus_s\": %.2f, \"ssr_switches\": %u, ",
+               m.iae_cs, m.aboveLiquidus_s, (unsigned)m.ssrSwitches);
+        printf("\"max_cool_rate_cs\": %.2f, ", m.maxCoolRate_cs);
+        if (opt.profile > 0)
+        {
+            const Profile::RunMetrics &rm = profile.getRunMetrics();
+            printf("\"energy_wh\": %.1f, \"segment_duty\": [", rm.energy_dWh / 10.0);
+            for (uint8_t i = 0; i < PROFILE_SEGMENTS_MAX; i++)
+                printf(rm.segmentDuty[i] == PROFILE_DUTY_SKIPPED ? "%snull" : "%s%u", i ? ", " : "", rm.segmentDuty[i]);
+            printf("], ");
+        }
+        printf("\"duration_s\": %.1f}\n", m.duration_s);
+    }
+}
+
+int main(int argc, char **argv)
+{
+    Replay::Options opt;
+    std::vector<const char *> files;
+
+    tcMock.install();
+
+    for (int i = 1; i < argc; i++)
+    {
+        std::string a = argv[i];
+        bool hasValue = i + 1 < argc;
+
+        if (a == "--replay")
+            opt.replay = true;
+        else if (a == "--run" && hasValue)
+            opt.run = atoi(argv[++i]);
+        else if (a == "--profile" && hasValue)
+            opt.profile = atoi(argv[++i]);
+        else if (a == "--setpoint" && hasValue)
+            opt.setpoint_c = atof(argv[++i]);
+        else if (a == "--start-temp" && hasValue)
+            opt.startTemp_c = atof(argv[++i]);
+        else if (a == "--cold-start")
+            opt.coldStart = true;
+        else if (a == "--duration" && hasValue)
+            opt.duration_s = atof(argv[++i]);
+        else if (a == "--kp" && hasValue)
+            opt.kp = atof(argv[++i]);
+        else if (a == "--ki" && hasValue)
+            opt.ki = atof(argv[++i]);
+        else if (a == "--kd" && hasValue)
+            opt.kd = atof(argv[++i]);
+        else if (a == "--bang-on" && hasValue)
+            opt.bangOn_c = atoi(argv[++i]);
+        else if (a == "--bang-off" && hasValue)
+            opt.bangOff_c = atoi(argv[++i]);
+        else if (a == "--window" && hasValue)
+            opt.window_ms = atoi(argv[++i]);
+        else if (a == "--slew" && hasValue)
+            opt.slew_cs = atoi(argv[++i]);
+        else if (a == "--max-temp" && hasValue)
+            opt.maxTemp_c = atoi(argv[++i]);
+        else if (a == "--fan" && hasValue)
+            opt.fan_k = atof(argv[++i]);
+        else if (a == "--liquidus" && hasValue)
+            opt.liquidus_c = atof(argv[++i]);
+        else if (a == "--band" && hasValue)
+            opt.band_c = atof(argv[++i]);
+        else if (a.compare(0, 2, "--") == 0)
+        {
+            fprintf(stderr, "Unknown option %s, see src/main_replay.cpp for usage\n", a.c_str());
+            return 2;
+        }
+        else
+            files.push_back(argv[i]);
+    }
+    if (files.empty())
+    {
+        fprintf(stderr, "Usage: %s [options] <trace>..., see src/main_replay.cpp\n", argv[0]);
+        return 2;
+    }
+
+    for (const char *path : files)
+    {
+        std::vector<Replay::Trace> traces = Replay::loadTraces(path);
+        for (size_t r = 0; r < traces.size(); r++)
+        {
+            if ((opt.run && (size_t)opt.run != r + 1) || traces[r].size() < 10)
+                continue;
+            Replay::PlantModel model = Replay::identify(traces[r]);
+            Replay::Metrics m = Replay::simulate(traces[r], model, opt);
+            Replay::printJson(path, r + 1, model, m, opt);
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,77 @@
+/*
+ * This file is part of the Another-HotPlate-Firmware project (https://github.com/Apehaenger/Another-HotPlate-Firmware).
+ * Copyright (c) 2022 Jörg Ebeling
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * Host unit tests of formatNumber()/appendNumber(): pio test -e TEST
+ */
+#include <unity.h>
+#include "Format.hpp"
+
+void setUp() {}
+void tearDown() {}
+
+static void test_three_digits_fill_buffer()
+{
+    char buf[4]; // 3 digits + '\0', no sign slot needed
+    TEST_ASSERT_EQUAL_STRING("250", formatNumber(buf, sizeof(buf), (uint8_t)250));
+    TEST_ASSERT_EQUAL_STRING("255", formatNumber(buf, sizeof(buf), 255));
+    TEST_ASSERT_EQUAL_STRING("  7", formatNumber(buf, sizeof(buf), 7, 3));
+}
+
+static void test_negative()
+{
+    char buf[5]; // Sign + 3 digits + '\0'
+    TEST_ASSERT_EQUAL_STRING("-250", formatNumber(buf, sizeof(buf), (int16_t)-250));
+    TEST_ASSERT_EQUAL_STRING("  -5", formatNumber(buf, sizeof(buf), -5, 4));
+}
+
+static void test_decimal()
+{
+    char buf[8];
+    TEST_ASSERT_EQUAL_STRING("249.5", formatNumber(buf, sizeof(buf), (int16_t)2495, 0, true));
+    TEST_ASSERT_EQUAL_STRING("-12.3", formatNumber(buf, sizeof(buf), (int16_t)-123, 0, true));
+    TEST_ASSERT_EQUAL_STRING("  0.4", formatNumber(buf, sizeof(buf), 4, 5, true));
+}
+
+static void test_truncated_without_overflow()
+{
+    char buf[6] = {'#', '#', '#', '#', '#', '#'};
+    TEST_ASSERT_EQUAL_STRING("3456", formatNumber(buf + 1, 5, 123456)); // Keeps the low digits
+    TEST_ASSERT_EQUAL_CHAR('#', buf[0]);
+    TEST_ASSERT_EQUAL_STRING("-56", formatNumber(buf + 1, 4, -123456));
+    TEST_ASSERT_EQUAL_CHAR('#', buf[0]);
+    TEST_ASSERT_EQUAL_STRING("6.4", formatNumber(buf + 1, 4, 1234564, 0, true));
+    TEST_ASSERT_EQUAL_CHAR('#', buf[0]);
+}
+
+static void test_append()
+{
+    char line[20] = "Peak: ";
+    appendNumber(line, (int16_t)2487, 0, true);
+    TEST_ASSERT_EQUAL_STRING("Peak: 248.7", line);
+}
+
+int main()
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_three_digits_fill_buffer);
+    RUN_TEST(test_negative);
+    RUN_TEST(test_decimal);
+    RUN_TEST(test_truncated_without_overflow);
+    RUN_TEST(test_append);
+    return UNITY_END();
+}